@@ -0,0 +1,189 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "affinity.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<std::string,int> Affinity::m_placement;
+std::map<int,std::vector<int> > Affinity::m_nodeCpus;
+int Affinity::m_users = 0;
+bool Affinity::m_warned = false;
+std::mutex Affinity::m_mutex;
+
+Affinity::Affinity( Mode mode, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_mode(mode), m_jobId(jobId), m_rank(rank), m_pinned(false)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Affinity::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+#ifndef __linux__
+    m_output.fatal(CALL_INFO,-1,"workloadAffinity is only supported on Linux\n");
+#endif
+}
+
+#ifdef __linux__
+// the cpus of the NUMA node cpu belongs to, empty if sysfs doesn't say
+std::vector<int> Affinity::nodeCpus( int cpu, int& node )
+{
+    node = -1;
+    std::stringstream dirName;
+    dirName << "/sys/devices/system/cpu/cpu" << cpu;
+    DIR* dir = opendir( dirName.str().c_str() );
+    if ( NULL == dir ) {
+        return std::vector<int>();
+    }
+    struct dirent* entry;
+    while ( ( entry = readdir( dir ) ) ) {
+        if ( 0 == strncmp( entry->d_name, "node", 4 ) && isdigit( entry->d_name[4] ) ) {
+            node = atoi( entry->d_name + 4 );
+            break;
+        }
+    }
+    closedir( dir );
+    if ( -1 == node ) {
+        return std::vector<int>();
+    }
+
+    auto iter = m_nodeCpus.find( node );
+    if ( iter != m_nodeCpus.end() ) {
+        return iter->second;
+    }
+
+    // the list looks like "0-7,16-23"
+    std::vector<int>& cpus = m_nodeCpus[node];
+    std::stringstream listName;
+    listName << "/sys/devices/system/node/node" << node << "/cpulist";
+    std::ifstream list( listName.str() );
+    std::string range;
+    while ( std::getline( list, range, ',' ) ) {
+        int first, last;
+        int num = sscanf( range.c_str(), "%d-%d", &first, &last );
+        if ( num < 1 ) {
+            continue;
+        }
+        if ( 1 == num ) {
+            last = first;
+        }
+        for ( int i = first; i <= last; i++ ) {
+            cpus.push_back( i );
+        }
+    }
+    return cpus;
+}
+#endif
+
+// an SST thread that is not pinned passes its whole mask on
+void Affinity::pin( std::thread& thread )
+{
+#ifdef __linux__
+    cpu_set_t sstSet;
+    int rc = pthread_getaffinity_np( pthread_self(), sizeof(sstSet), &sstSet );
+    if ( rc ) {
+        m_output.output("pthread_getaffinity_np failed: %s, workload thread is not pinned\n",strerror(rc));
+        return;
+    }
+    std::vector<int> sstCpus;
+    for ( int i = 0; i < CPU_SETSIZE; i++ ) {
+        if ( CPU_ISSET( i, &sstSet ) ) {
+            sstCpus.push_back( i );
+        }
+    }
+    if ( sstCpus.empty() ) {
+        m_output.output("the SST thread has no cpus in its mask, workload thread is not pinned\n");
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    std::stringstream place;
+
+    std::lock_guard<std::mutex> lck(m_mutex);
+    if ( Numa == m_mode ) {
+        // the node all the SST thread's cpus belong to, if there is one
+        int node = -1;
+        std::vector<int> cpus;
+        for ( auto cpu : sstCpus ) {
+            int cpuNode;
+            cpus = nodeCpus( cpu, cpuNode );
+            if ( -1 == cpuNode || ( -1 != node && cpuNode != node ) ) {
+                node = -1;
+                break;
+            }
+            node = cpuNode;
+        }
+        if ( -1 != node ) {
+            for ( auto i : cpus ) {
+                CPU_SET( i, &set );
+            }
+            place << "node " << node;
+        }
+    }
+    if ( place.str().empty() && 1 == sstCpus.size() ) {
+        CPU_SET( sstCpus[0], &set );
+        place << "cpu " << sstCpus[0];
+    }
+    if ( place.str().empty() ) {
+        if ( ! m_warned ) {
+            m_output.output("the SST thread is not pinned to a %s, the workload thread gets its mask of %zu cpus,"
+                    " pin the SST threads for workloadAffinity to take effect\n",Numa == m_mode ? "NUMA node" : "cpu",sstCpus.size());
+            m_warned = true;
+        }
+        set = sstSet;
+        place << "unpinned";
+    }
+
+    rc = pthread_setaffinity_np( thread.native_handle(), sizeof(set), &set );
+    if ( rc ) {
+        m_output.output("pthread_setaffinity_np failed: %s, workload thread is not pinned\n",strerror(rc));
+        return;
+    }
+    m_output.debug(CALL_INFO, 1, SWM_AFFINITY_DBG_MASK,"workload thread pinned to %s\n",place.str().c_str());
+    if ( ! m_pinned ) {
+        ++m_placement[place.str()];
+        ++m_users;
+    }
+    m_pinned = true;
+#endif
+}
+
+void Affinity::finish()
+{
+    if ( ! m_pinned ) {
+        return;
+    }
+    std::lock_guard<std::mutex> lck(m_mutex);
+    if ( 0 == --m_users ) {
+        std::stringstream report;
+        for ( auto& iter : m_placement ) {
+            report << " " << iter.first << ":" << iter.second;
+        }
+        m_output.output("workload thread placement%s\n",report.str().c_str());
+        m_placement.clear();
+    }
+}
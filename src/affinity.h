@@ -0,0 +1,69 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_AFFINITY_H
+#define _SWM_AFFINITY_H
+
+#include <sst/core/output.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Pins a rank's workload thread next to the SST thread that owns its component. The
+// two threads strictly alternate so sharing the SST thread's core costs nothing and
+// keeps the handoff in one cache, "numa" allows any core of the same NUMA node. The
+// core or node is taken from the SST thread's affinity mask, so the SST threads must
+// be pinned (e.g. by the MPI launcher) for this to have an effect. pin() must be
+// called from the owning SST thread. Linux only.
+class Affinity {
+  public:
+    enum Mode { Core, Numa };
+
+    Affinity( Mode mode, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask );
+
+    // the thread of each stage of a chained workload is pinned, it is counted once
+    void pin( std::thread& thread );
+    void finish();
+
+  private:
+    std::vector<int> nodeCpus( int cpu, int& node );
+
+    Output  m_output;
+    Mode    m_mode;
+    int     m_jobId;
+    int     m_rank;
+    bool    m_pinned;
+
+    // the unpinned SST thread warning is printed once per process
+    static bool m_warned;
+    // number of workload threads placed on each core or node, printed when the last one finishes
+    static std::map<std::string,int> m_placement;
+    static std::map<int,std::vector<int> > m_nodeCpus;
+    static int m_users;
+    static std::mutex m_mutex;
+};
+
+}
+}
+
+#endif
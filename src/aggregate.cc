@@ -0,0 +1,112 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+
+#include "aggregate.h"
+#include "report.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<Aggregator::Key,std::deque<std::vector<Aggregator::Message> > > Aggregator::m_inFlight;
+std::mutex Aggregator::m_mutex;
+
+Aggregator::Aggregator( int jobId, int rank, uint64_t maxBytes, uint64_t limit, SimTime_t window,
+        uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_rank(rank), m_maxBytes(maxBytes), m_limit(limit), m_window(window), m_held(0), m_oldest(0)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Aggregator::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    requireOneProcess( m_output, "message aggregation" );
+}
+
+void Aggregator::add( int dst, const Message& msg, SimTime_t now )
+{
+    if ( empty() ) {
+        m_oldest = now;
+    }
+    m_batches[dst].push_back( msg );
+    m_held += msg.bytes;
+    m_output.debug(CALL_INFO, 2, SWM_AGGREGATE_DBG_MASK,"dst=%d tag=%#x bytes=%" PRIu64 " held=%" PRIu64 "\n",dst,msg.tag,msg.bytes,m_held);
+}
+
+void Aggregator::flush( int* dst, uint64_t* bytes )
+{
+    auto iter = m_batches.begin();
+    *dst = iter->first;
+    *bytes = 0;
+    for ( auto& msg : iter->second ) {
+        *bytes += msg.bytes;
+    }
+    m_output.debug(CALL_INFO, 1, SWM_AGGREGATE_DBG_MASK,"dst=%d messages=%zu bytes=%" PRIu64 "\n",*dst,iter->second.size(),*bytes);
+    {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        m_inFlight[ Key( m_jobId, m_rank, *dst ) ].push_back( std::move( iter->second ) );
+    }
+    m_held -= *bytes;
+    m_batches.erase( iter );
+}
+
+// batches from a sender arrive in the order they were sent
+void Aggregator::unpack( int src )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    auto iter = m_inFlight.find( Key( m_jobId, src, m_rank ) );
+    if ( iter == m_inFlight.end() ) {
+        m_output.fatal(CALL_INFO,-1,"no batch from %d\n",src);
+    }
+    std::vector<Message>& batch = iter->second.front();
+    m_output.debug(CALL_INFO, 1, SWM_AGGREGATE_DBG_MASK,"src=%d messages=%zu\n",src,batch.size());
+    m_unexpected.insert( m_unexpected.end(), batch.begin(), batch.end() );
+    iter->second.pop_front();
+    if ( iter->second.empty() ) {
+        m_inFlight.erase( iter );
+    }
+}
+
+bool Aggregator::match( int src, const Communicators::Members* comm, int tag, Message* msg )
+{
+    for ( auto iter = m_unexpected.begin(); iter != m_unexpected.end(); ++iter ) {
+        if ( matches( src, comm, tag, *iter ) ) {
+            *msg = *iter;
+            m_unexpected.erase( iter );
+            return true;
+        }
+    }
+    return false;
+}
+
+void Aggregator::post( uint32_t id, int src, const Communicators::Members* comm, int tag )
+{
+    Posted posted = { id, src, comm, tag };
+    m_posted.push_back( posted );
+}
+
+// posted receives are matched in the order they were posted
+bool Aggregator::matchPosted( uint32_t* id, Message* msg )
+{
+    for ( auto iter = m_posted.begin(); iter != m_posted.end(); ++iter ) {
+        if ( match( iter->src, iter->comm, iter->tag, msg ) ) {
+            *id = iter->id;
+            m_posted.erase( iter );
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,106 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _SWM_AGGREGATE_H
+#define _SWM_AGGREGATE_H
+
+#include <sst/core/output.h>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "dbg.h"
+#include "communicator.h"
+
+namespace SST {
+namespace Swm {
+
+// Small message aggregation. Messages of at most maxBytes are not sent on their own,
+// the sender collects them per destination and sends each batch as one message, the
+// receiver unpacks it and matches its receives of at most maxBytes against the
+// messages it held. Which messages go in batches is decided by size on both sides, so
+// a skeleton's receive has to be small exactly when the send it matches is.
+//
+// Batches go out before any call that could wait on them, or at the next call once the
+// oldest held message is window ns old or limit bytes are held. Their content is passed
+// through a per job table in order.
+class Aggregator {
+  public:
+    // src is the sender's rank in comm, comm is the communicator's interned member list as
+    // comm_ids are only meaningful to the rank that holds them
+    struct Message {
+        int         src;
+        const Communicators::Members* comm;
+        int         tag;
+        uint64_t    bytes;
+    };
+
+    Aggregator( int jobId, int rank, uint64_t maxBytes, uint64_t limit, SimTime_t window,
+            uint32_t verboseLevel, uint32_t verboseMask );
+
+    bool small( uint64_t bytes ) { return bytes <= m_maxBytes; }
+    // a receive buffer large enough for any batch
+    uint64_t batchBytes() { return m_limit + m_maxBytes; }
+
+    void add( int dst, const Message& msg, SimTime_t now );
+    bool empty() { return m_batches.empty(); }
+    bool due( SimTime_t now ) { return ! empty() && ( m_held >= m_limit || now >= m_oldest + m_window ); }
+    // passes the next batch to its receiver, returns the world rank it goes to and its size
+    void flush( int* dst, uint64_t* bytes );
+
+    // a batch from world rank src arrived
+    void unpack( int src );
+    // src and tag can be -1 for any
+    bool match( int src, const Communicators::Members* comm, int tag, Message* msg );
+    void post( uint32_t id, int src, const Communicators::Members* comm, int tag );
+    bool matchPosted( uint32_t* id, Message* msg );
+
+  private:
+    struct Posted {
+        uint32_t    id;
+        int         src;
+        const Communicators::Members* comm;
+        int         tag;
+    };
+    static bool matches( int src, const Communicators::Members* comm, int tag, const Message& msg ) {
+        return ( src == -1 || src == msg.src ) && comm == msg.comm && ( tag == -1 || tag == msg.tag );
+    }
+
+    Output      m_output;
+    int         m_jobId;
+    int         m_rank;
+    uint64_t    m_maxBytes;
+    uint64_t    m_limit;
+    SimTime_t   m_window;
+    uint64_t    m_held;
+    SimTime_t   m_oldest;
+    std::map<int,std::vector<Message> > m_batches;
+    std::list<Message>  m_unexpected;
+    std::list<Posted>   m_posted;
+
+    typedef std::tuple<int,int,int> Key;
+    static std::map<Key,std::deque<std::vector<Message> > > m_inFlight;
+    static std::mutex m_mutex;
+};
+
+}
+}
+
+#endif
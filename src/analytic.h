@@ -0,0 +1,72 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_ANALYTIC_H
+#define _SWM_ANALYTIC_H
+
+#include <sst/core/sst_types.h>
+
+#include <cmath>
+
+namespace SST {
+namespace Swm {
+
+// latency/bandwidth estimate for communication that is not simulated,
+// a latency and bandwidth of 0 completes everything instantly,
+// collectives are timed for the size of the communicator they run on
+class AnalyticModel {
+  public:
+    // latency in ns, bandwidth in GB/s which is bytes per ns
+    AnalyticModel( double latency = 0, double bandwidth = 0 ) :
+        m_latency(latency), m_bandwidth(bandwidth)
+    { }
+
+    SimTime_t pt2pt( uint64_t bytes ) {
+        return m_latency + ( m_bandwidth > 0 ? bytes / m_bandwidth : 0 );
+    }
+
+    // binomial tree reduce followed by a binomial tree broadcast
+    SimTime_t allreduce( uint64_t bytes, int size ) {
+        return 2 * steps( size ) * pt2pt( bytes );
+    }
+
+    // dissemination
+    SimTime_t barrier( int size ) {
+        return steps( size ) * pt2pt( 0 );
+    }
+
+    // pairwise exchange, bytes to every other rank
+    SimTime_t alltoall( uint64_t bytes, int size ) {
+        return ( size - 1 ) * pt2pt( bytes );
+    }
+
+  private:
+    // ceil(log2(size))
+    static int steps( int size ) {
+        int steps = 0;
+        while ( (1 << steps) < size ) {
+            ++steps;
+        }
+        return steps;
+    }
+
+    double m_latency;
+    double m_bandwidth;
+};
+
+}
+}
+
+#endif
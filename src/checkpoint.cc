@@ -0,0 +1,159 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "checkpoint.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<int,Checkpoint::Job> Checkpoint::m_jobs;
+std::mutex Checkpoint::m_jobsMutex;
+
+Checkpoint::Checkpoint( int jobId, int rank, int numRanks, std::string path, int interval, std::string restartPath,
+        uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_rank(rank), m_numRanks(numRanks), m_interval(interval), m_syncCount(0), m_restartOp(0), m_restartTime(0)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Checkpoint::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    if ( m_interval < 1 ) {
+        m_output.fatal(CALL_INFO,-1,"checkpointInterval must be greater than 0\n");
+    }
+    // the checkpoint file is appended to, it can't be the one the restart reads
+    if ( ! path.empty() && 0 == path.compare( restartPath ) ) {
+        m_output.fatal(CALL_INFO,-1,"checkpointPath and restartPath are both %s, checkpoint to a different file\n",path.c_str());
+    }
+
+    std::unique_lock<std::mutex> jobsLck(m_jobsMutex);
+    Job& job = m_jobs[jobId];
+    jobsLck.unlock();
+
+    std::unique_lock<std::mutex> lck(job.mutex);
+
+    if ( ! path.empty() ) {
+        if ( NULL == job.file ) {
+            std::stringstream name;
+            name << path << "." << jobId;
+            job.file = fopen( name.str().c_str(), "a" );
+            if ( NULL == job.file ) {
+                m_output.fatal(CALL_INFO,-1,"could not open checkpoint file %s\n",name.str().c_str());
+            }
+        }
+        ++job.users;
+    }
+
+    if ( ! restartPath.empty() ) {
+        if ( ! job.restartRead ) {
+            readRestart( restartPath );
+        }
+        if ( ! job.restartOp.empty() ) {
+            m_restartOp = job.restartOp[rank];
+            m_restartTime = job.restartTime;
+        }
+    }
+    m_output.debug(CALL_INFO, 1, SWM_CHECKPOINT_DBG_MASK,"restartOp=%" PRIu64 " restartTime=%" PRIu64 "\n",m_restartOp,m_restartTime);
+}
+
+Checkpoint::~Checkpoint()
+{
+    std::unique_lock<std::mutex> jobsLck(m_jobsMutex);
+    Job& job = m_jobs[m_jobId];
+    jobsLck.unlock();
+
+    std::unique_lock<std::mutex> lck(job.mutex);
+    if ( job.file && 0 == --job.users ) {
+        fclose( job.file );
+        job.file = NULL;
+    }
+}
+
+void Checkpoint::sync( uint64_t opIndex, SimTime_t now )
+{
+    ++m_syncCount;
+
+    // syncs passed while fast forwarding after a restart are only counted
+    if ( opIndex <= m_restartOp || m_syncCount % m_interval ) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> jobsLck(m_jobsMutex);
+    Job& job = m_jobs.at(m_jobId);
+    jobsLck.unlock();
+
+    std::unique_lock<std::mutex> lck(job.mutex);
+    if ( NULL == job.file ) {
+        return;
+    }
+    m_output.debug(CALL_INFO, 1, SWM_CHECKPOINT_DBG_MASK,"sync=%" PRIu64 " opIndex=%" PRIu64 " now=%" PRIu64 "\n",m_syncCount,opIndex,now);
+    fprintf( job.file, "%d %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", m_rank, m_syncCount, opIndex, now );
+    fflush( job.file );
+}
+
+// called with the job mutex held, the file is "rank sync opIndex time" per line
+void Checkpoint::readRestart( std::string path )
+{
+    Job& job = m_jobs.at(m_jobId);
+    job.restartRead = true;
+
+    std::stringstream name;
+    name << path << "." << m_jobId;
+
+    std::ifstream file( name.str() );
+    if ( ! file.is_open() ) {
+        m_output.fatal(CALL_INFO,-1,"could not open restart file %s\n",name.str().c_str());
+    }
+
+    // first pass finds the last sync every rank reached
+    std::map<uint64_t,std::pair<int,SimTime_t> > syncs;
+    int rank;
+    uint64_t sync,opIndex;
+    SimTime_t time;
+    while ( file >> rank >> sync >> opIndex >> time ) {
+        auto& entry = syncs[sync];
+        ++entry.first;
+        entry.second = std::max( entry.second, time );
+    }
+
+    uint64_t restartSync = 0;
+    for ( auto iter = syncs.rbegin(); iter != syncs.rend(); ++iter ) {
+        if ( iter->second.first == m_numRanks ) {
+            restartSync = iter->first;
+            job.restartTime = iter->second.second;
+            break;
+        }
+    }
+
+    if ( 0 == restartSync ) {
+        m_output.output("job %d: no complete checkpoint in %s, starting from the beginning\n",m_jobId,name.str().c_str());
+        return;
+    }
+
+    file.clear();
+    file.seekg( 0 );
+    job.restartOp.resize( m_numRanks, 0 );
+    while ( file >> rank >> sync >> opIndex >> time ) {
+        if ( sync == restartSync ) {
+            job.restartOp.at(rank) = opIndex;
+        }
+    }
+
+    m_output.output("job %d: restarting from sync %" PRIu64 " at %" PRIu64 " ns\n",m_jobId,restartSync,job.restartTime);
+}
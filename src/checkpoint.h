@@ -0,0 +1,76 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_CHECKPOINT_H
+#define _SWM_CHECKPOINT_H
+
+#include <sst/core/output.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// A rank's progress is its position in the deterministic stream of SWM calls, tests and
+// Waitsome left out. Positions are recorded when a rank leaves a collective on the world
+// communicator with no requests outstanding, every rank of the job records the
+// same sync number at that point so a sync that all ranks reached is a
+// consistent cut. On restart each rank fast forwards its skeleton through the
+// calls up to that position and resumes at the simulated time of the cut.
+class Checkpoint {
+  public:
+    Checkpoint( int jobId, int rank, int numRanks, std::string path, int interval, std::string restartPath,
+            uint32_t verboseLevel, uint32_t verboseMask );
+    ~Checkpoint();
+
+    void sync( uint64_t opIndex, SimTime_t now );
+
+    uint64_t  restartOp()   { return m_restartOp; }
+    SimTime_t restartTime() { return m_restartTime; }
+
+  private:
+    void readRestart( std::string path );
+
+    Output      m_output;
+    int         m_jobId;
+    int         m_rank;
+    int         m_numRanks;
+    int         m_interval;
+    uint64_t    m_syncCount;
+    uint64_t    m_restartOp;
+    SimTime_t   m_restartTime;
+
+    struct Job {
+        Job() : file(NULL), users(0), restartRead(false), restartTime(0) {}
+        std::mutex mutex;
+        FILE* file;
+        int users;
+        bool restartRead;
+        SimTime_t restartTime;
+        std::vector<uint64_t> restartOp;
+    };
+    static std::map<int,Job> m_jobs;
+    static std::mutex m_jobsMutex;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,154 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include "commmatrix.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+JobReport<std::vector<CommMatrix::Row> > CommMatrix::m_jobs;
+
+CommMatrix::CommMatrix( int jobId, int rank, int numRanks, Communicators* comms, std::string path, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_rank(rank), m_numRanks(numRanks), m_comms(comms), m_path(path)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:CommMatrix::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    m_jobs.join( jobId );
+}
+
+void CommMatrix::recordAllreduce( int comm_id, uint64_t bytes )
+{
+    int rank = m_comms->rank( comm_id );
+    int size = m_comms->size( comm_id );
+    for ( int mask = 1; mask < size; mask <<= 1 ) {
+        int peer = rank ^ mask;
+        if ( peer < size ) {
+            record( peer, comm_id, Collective, bytes );
+        }
+    }
+}
+
+void CommMatrix::recordBarrier( int comm_id )
+{
+    int rank = m_comms->rank( comm_id );
+    int size = m_comms->size( comm_id );
+    for ( int dist = 1; dist < size; dist <<= 1 ) {
+        record( ( rank + dist ) % size, comm_id, Collective, 0 );
+    }
+}
+
+void CommMatrix::recordAlltoall( int comm_id, uint64_t bytes )
+{
+    int rank = m_comms->rank( comm_id );
+    int size = m_comms->size( comm_id );
+    for ( int peer = 0; peer < size; peer++ ) {
+        if ( peer != rank ) {
+            record( peer, comm_id, Collective, bytes );
+        }
+    }
+}
+
+void CommMatrix::finish()
+{
+    std::vector<Comm> comms( m_lists.size() );
+    for ( auto& iter : m_lists ) {
+        comms[iter.second] = iter.first;
+    }
+    Row row;
+    for ( auto& iter : m_entries ) {
+        Item item = { (int32_t) iter.first, comms[iter.first >> 33], (uint8_t) ( ( iter.first >> 32 ) & 1 ),
+                iter.second.count, iter.second.bytes };
+        row.push_back( item );
+    }
+    m_entries.clear();
+    m_lists.clear();
+
+    m_output.debug(CALL_INFO, 1, SWM_COMMMATRIX_DBG_MASK,"%zu entries\n",row.size());
+
+    m_jobs.leave( m_jobId,
+            [&]( std::vector<Row>& rows ) {
+                rows.resize( m_numRanks );
+                rows[m_rank] = std::move(row);
+            },
+            [this]( std::vector<Row>& rows ) { write( rows ); } );
+}
+
+// The file is "SWMCOMM1", int32 jobId, int32 numRanks, uint64 nnz, uint64 rowPtr[numRanks+1],
+// then the entries as arrays: int32 peer[nnz] (a world rank), int32 comm[nnz], uint8 kind[nnz],
+// uint64 count[nnz], uint64 bytes[nnz], then int32 numComms and for each communicator its
+// int32 size and int32 members[size] (world ranks). comm indexes that table, which is
+// ordered largest first and then by members so the world communicator is 0, communicators
+// with the same members share an entry. Row r holds what rank r sent, sorted by peer,
+// rows of ranks simulated by another SST process are empty.
+void CommMatrix::write( std::vector<Row>& rows )
+{
+    FILE* fp = openJobFile( m_output, m_path, m_jobId, "wb", "communication matrix" );
+
+    std::vector<Comm> comms;
+    for ( auto& row : rows ) {
+        for ( auto& item : row ) {
+            comms.push_back( item.comm );
+        }
+    }
+    std::sort( comms.begin(), comms.end() );
+    comms.erase( std::unique( comms.begin(), comms.end() ), comms.end() );
+    std::sort( comms.begin(), comms.end(),
+            []( Comm a, Comm b ) { return a->size() > b->size() || ( a->size() == b->size() && *a < *b ); } );
+    std::map<Comm,int32_t> index;
+    for ( size_t i = 0; i < comms.size(); i++ ) {
+        index[comms[i]] = i;
+    }
+
+    std::vector<uint64_t> rowPtr( 1, 0 );
+    for ( auto& row : rows ) {
+        std::sort( row.begin(), row.end(),
+                [&]( const Item& a, const Item& b ) {
+                    return std::make_tuple( a.peer, index[a.comm], a.kind ) < std::make_tuple( b.peer, index[b.comm], b.kind );
+                } );
+        rowPtr.push_back( rowPtr.back() + row.size() );
+    }
+    int32_t jobId = m_jobId;
+    int32_t numRanks = m_numRanks;
+    uint64_t nnz = rowPtr.back();
+
+    fwrite( "SWMCOMM1", 1, 8, fp );
+    fwrite( &jobId, sizeof(jobId), 1, fp );
+    fwrite( &numRanks, sizeof(numRanks), 1, fp );
+    fwrite( &nnz, sizeof(nnz), 1, fp );
+    fwrite( rowPtr.data(), sizeof(uint64_t), rowPtr.size(), fp );
+    for ( auto& row : rows ) for ( auto& item : row ) fwrite( &item.peer, sizeof(int32_t), 1, fp );
+    for ( auto& row : rows ) for ( auto& item : row ) fwrite( &index[item.comm], sizeof(int32_t), 1, fp );
+    for ( auto& row : rows ) for ( auto& item : row ) fwrite( &item.kind, sizeof(uint8_t), 1, fp );
+    for ( auto& row : rows ) for ( auto& item : row ) fwrite( &item.count, sizeof(uint64_t), 1, fp );
+    for ( auto& row : rows ) for ( auto& item : row ) fwrite( &item.bytes, sizeof(uint64_t), 1, fp );
+    int32_t numComms = comms.size();
+    fwrite( &numComms, sizeof(numComms), 1, fp );
+    for ( auto comm : comms ) {
+        int32_t size = comm->size();
+        fwrite( &size, sizeof(size), 1, fp );
+        fwrite( comm->data(), sizeof(int32_t), size, fp );
+    }
+    fclose( fp );
+
+    m_output.output("job %d: communication matrix with %" PRIu64 " entries written to %s\n",m_jobId,nnz,jobFileName( m_path, m_jobId ).c_str());
+}
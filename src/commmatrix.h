@@ -0,0 +1,112 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_COMMMATRIX_H
+#define _SWM_COMMMATRIX_H
+
+#include <sst/core/output.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dbg.h"
+#include "report.h"
+#include "communicator.h"
+
+namespace SST {
+namespace Swm {
+
+// Per rank sparse matrix of the messages and bytes a rank sends, keyed by peer,
+// communicator and whether the traffic is point to point or part of a collective.
+// Peers are world ranks, a peer given as a rank in the communicator the traffic was
+// sent on is looked up in its members. comm_ids are local to a rank so communicators
+// are recorded by their interned member list. At finish the ranks of a job that live
+// in this process are merged into one CSR file, see write().
+class CommMatrix {
+  public:
+    enum Kind { Pt2Pt = 0, Collective = 1 };
+
+    CommMatrix( int jobId, int rank, int numRanks, Communicators* comms, std::string path, uint32_t verboseLevel, uint32_t verboseMask );
+
+    // peer is a rank in communicator comm_id
+    void record( int peer, int comm_id, Kind kind, uint64_t bytes ) {
+        recordWorld( m_comms->world( comm_id, peer ), &m_comms->members( comm_id ), kind, bytes );
+    }
+
+    // the messages a recursive doubling allreduce, a dissemination barrier or a pairwise
+    // alltoall sends, among the members of communicator comm_id
+    void recordAllreduce( int comm_id, uint64_t bytes );
+    void recordBarrier( int comm_id );
+    void recordAlltoall( int comm_id, uint64_t bytes );
+
+    void finish();
+
+  private:
+    typedef const Communicators::Members* Comm;
+
+    void recordWorld( int peer, Comm comm, Kind kind, uint64_t bytes ) {
+        Entry& entry = m_entries[ key( peer, list( comm ), kind ) ];
+        ++entry.count;
+        entry.bytes += bytes;
+    }
+
+    struct Entry {
+        Entry() : count(0), bytes(0) {}
+        uint64_t count;
+        uint64_t bytes;
+    };
+
+    // a small per rank number for each member list, so the key stays one word
+    uint32_t list( Comm comm ) {
+        auto iter = m_lists.find( comm );
+        if ( iter == m_lists.end() ) {
+            iter = m_lists.insert( std::make_pair( comm, (uint32_t) m_lists.size() ) ).first;
+        }
+        return iter->second;
+    }
+
+    static uint64_t key( int peer, uint32_t list, Kind kind ) {
+        return (uint64_t) (uint32_t) peer | (uint64_t) kind << 32 | (uint64_t) list << 33;
+    }
+
+    struct Item {
+        int32_t  peer;
+        Comm     comm;
+        uint8_t  kind;
+        uint64_t count;
+        uint64_t bytes;
+    };
+    typedef std::vector<Item> Row;
+
+    void write( std::vector<Row>& rows );
+
+    Output      m_output;
+    int         m_jobId;
+    int         m_rank;
+    int         m_numRanks;
+    Communicators* m_comms;
+    std::string m_path;
+    std::unordered_map<uint64_t,Entry> m_entries;
+    std::map<Comm,uint32_t> m_lists;
+
+    static JobReport<std::vector<Row> > m_jobs;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+
+#include <algorithm>
+
+#include "communicator.h"
+#include "report.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<int,std::set<Communicators::Members> > Communicators::m_members;
+std::map<Communicators::RoundKey,Communicators::Round> Communicators::m_rounds;
+std::mutex Communicators::m_mutex;
+
+Communicators::Communicators( int jobId, int rank, int numRanks, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_rank(rank)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Communicators::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    Members world( numRanks );
+    for ( int i = 0; i < numRanks; i++ ) {
+        world[i] = i;
+    }
+    Comm comm = { Hermes::MP::GroupWorld, intern( jobId, world ), rank };
+    m_comms.push_back( comm );
+}
+
+const Communicators::Members* Communicators::intern( int jobId, const Members& members )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    return &*m_members[jobId].insert( members ).first;
+}
+
+int Communicators::add( Hermes::MP::Communicator hermes, const Members& members )
+{
+    auto iter = std::find( members.begin(), members.end(), m_rank );
+    if ( iter == members.end() ) {
+        m_output.fatal(CALL_INFO,-1,"rank %d is not a member of the new communicator\n",m_rank);
+    }
+    Comm comm = { hermes, intern( m_jobId, members ), (int) ( iter - members.begin() ) };
+    m_comms.push_back( comm );
+    m_output.debug(CALL_INFO, 1, SWM_COMMUNICATOR_DBG_MASK,"id=%zu size=%zu rank=%d\n",m_comms.size()-1,members.size(),comm.rank);
+    return m_comms.size() - 1;
+}
+
+void Communicators::free( int id )
+{
+    if ( 0 == id ) {
+        m_output.fatal(CALL_INFO,-1,"the world communicator can't be freed\n");
+    }
+    get( id ).members = NULL;
+}
+
+void Communicators::deposit( int parent, int color, int key )
+{
+    requireOneProcess( m_output, "splitting a communicator" );
+    Comm& comm = get( parent );
+    RoundKey roundKey( m_jobId, comm.members, m_numSplits[comm.members] );
+
+    std::lock_guard<std::mutex> lck(m_mutex);
+    Round& round = m_rounds[roundKey];
+    round.deposits.resize( comm.members->size() );
+    round.deposits[comm.rank].color = color;
+    round.deposits[comm.rank].key = key;
+}
+
+Communicators::Members Communicators::split( int parent )
+{
+    Comm& comm = get( parent );
+    RoundKey roundKey( m_jobId, comm.members, m_numSplits[comm.members]++ );
+
+    std::lock_guard<std::mutex> lck(m_mutex);
+    Round& round = m_rounds.at( roundKey );
+    int color = round.deposits[comm.rank].color;
+    Members members;
+    if ( color >= 0 ) {
+        // ordered by key and then by rank in the parent
+        std::vector<std::pair<int,int> > order;
+        for ( size_t i = 0; i < round.deposits.size(); i++ ) {
+            if ( round.deposits[i].color == color ) {
+                order.push_back( std::make_pair( round.deposits[i].key, (int) i ) );
+            }
+        }
+        std::sort( order.begin(), order.end() );
+        for ( auto& iter : order ) {
+            members.push_back( (*comm.members)[iter.second] );
+        }
+    }
+    if ( ++round.taken == (int) round.deposits.size() ) {
+        m_rounds.erase( roundKey );
+    }
+    return members;
+}
+
+Communicators::Members Communicators::cartSub( int parent, int ndims, const int* dims, const int* remain )
+{
+    Comm& comm = get( parent );
+    int size = 1;
+    for ( int i = 0; i < ndims; i++ ) {
+        size *= dims[i];
+    }
+    if ( size != (int) comm.members->size() ) {
+        m_output.fatal(CALL_INFO,-1,"cartesian grid of %d ranks on a communicator of %zu\n",size,comm.members->size());
+    }
+
+    // the parent ranks whose coordinates in the dropped dimensions match ours, in rank order
+    std::vector<int> coord( ndims );
+    for ( int i = ndims - 1, rank = comm.rank; i >= 0; i-- ) {
+        coord[i] = rank % dims[i];
+        rank /= dims[i];
+    }
+    Members members;
+    for ( int other = 0; other < size; other++ ) {
+        bool match = true;
+        for ( int i = ndims - 1, rank = other; i >= 0; i-- ) {
+            match = match && ( remain[i] || rank % dims[i] == coord[i] );
+            rank /= dims[i];
+        }
+        if ( match ) {
+            members.push_back( (*comm.members)[other] );
+        }
+    }
+    return members;
+}
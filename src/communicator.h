@@ -0,0 +1,109 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_COMMUNICATOR_H
+#define _SWM_COMMUNICATOR_H
+
+#include <sst/core/output.h>
+#include <sst/elements/hermes/msgapi.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// The communicators a rank has created, by SWM comm_id. 0 is the world communicator,
+// ids of new communicators are handed out in creation order so ranks that create the
+// same communicators in the same order agree on their ids. Each communicator keeps the
+// world ranks of its members in rank order, the lists are interned per job so ranks
+// that share a communicator share one list. Splits exchange colors and keys through a
+// per job table, so a job that splits communicators must run in one SST process.
+class Communicators {
+  public:
+    typedef std::vector<int> Members;
+
+    Communicators( int jobId, int rank, int numRanks, uint32_t verboseLevel, uint32_t verboseMask );
+
+    Hermes::MP::Communicator hermes( int id ) {
+        return get( id ).hermes;
+    }
+    int rank( int id )      { return get( id ).rank; }
+    int size( int id )      { return get( id ).members->size(); }
+    const Members& members( int id ) { return *get( id ).members; }
+    // the world rank of a rank in communicator id
+    int world( int id, int rank ) { return get( id ).members->at( rank ); }
+
+    // adds a communicator Hermes knows as hermes, returns its id
+    int add( Hermes::MP::Communicator hermes, const Members& members );
+    void free( int id );
+
+    // A split is a deposit by every member of the parent, a barrier on the parent and
+    // then each member reading back the members of its color. A color of -1 gives no
+    // communicator, the returned list is empty.
+    void deposit( int parent, int color, int key );
+    Members split( int parent );
+
+    // the world ranks of the members of a cartesian sub-grid of parent, dims is the
+    // grid in row major order and remain the dimensions the sub-grid keeps
+    Members cartSub( int parent, int ndims, const int* dims, const int* remain );
+
+  private:
+    struct Comm {
+        Hermes::MP::Communicator hermes;
+        const Members* members;
+        int rank;
+    };
+
+    Comm& get( int id ) {
+        if ( id < 0 || id >= (int) m_comms.size() || NULL == m_comms[id].members ) {
+            m_output.fatal(CALL_INFO,-1,"unknown communicator %d\n",id);
+        }
+        return m_comms[id];
+    }
+
+    struct Deposit {
+        int color;
+        int key;
+    };
+    struct Round {
+        Round() : taken(0) {}
+        std::vector<Deposit> deposits;
+        int taken;
+    };
+    typedef std::tuple<int,const Members*,int> RoundKey;
+
+    Output  m_output;
+    int     m_jobId;
+    int     m_rank;
+    std::vector<Comm> m_comms;
+    // splits done on each parent, with the parent's member list they identify a split round
+    std::map<const Members*,int> m_numSplits;
+
+    static const Members* intern( int jobId, const Members& members );
+    static std::map<int,std::set<Members> > m_members;
+    static std::map<RoundKey,Round> m_rounds;
+    static std::mutex m_mutex;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,71 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#include "sst/core/sst_config.h"
+
+#include <algorithm>
+
+#include "contention.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<int,std::vector<Contention*> > Contention::m_active;
+std::mutex Contention::m_mutex;
+
+Contention::Contention( int jobId, int rank, int nodeId, double memoryFraction, int saturation, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_nodeId(nodeId), m_memoryFraction(memoryFraction), m_saturation(saturation), m_left(0), m_since(0), m_stretch(1)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Contention::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+}
+
+void Contention::reschedule( std::vector<Contention*>& active, int count, SimTime_t now )
+{
+    double stretch = this->stretch( count );
+    for ( auto other : active ) {
+        if ( other->m_stretch == stretch ) {
+            continue;
+        }
+        other->m_left = std::max( 0.0, other->m_left - ( now - other->m_since ) / other->m_stretch );
+        other->m_since = now;
+        other->m_stretch = stretch;
+        other->m_handler( other->m_left * stretch );
+    }
+}
+
+SimTime_t Contention::start( double ns, SimTime_t now )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    std::vector<Contention*>& active = m_active[m_nodeId];
+    reschedule( active, active.size() + 1, now );
+    active.push_back( this );
+
+    m_left = ns;
+    m_since = now;
+    m_stretch = stretch( active.size() );
+    m_output.debug(CALL_INFO, 2, SWM_CONTENTION_DBG_MASK,"node=%d active=%zu ns=%.0f stretch=%.2f\n",m_nodeId,active.size(),ns,m_stretch);
+    return ns * m_stretch;
+}
+
+void Contention::end( SimTime_t now )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    std::vector<Contention*>& active = m_active[m_nodeId];
+    active.erase( std::find( active.begin(), active.end(), this ) );
+    reschedule( active, active.size(), now );
+}
@@ -0,0 +1,79 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _SWM_CONTENTION_H
+#define _SWM_CONTENTION_H
+
+#include <sst/core/output.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Node level model of ranks that compute at the same time sharing the node's memory
+// bandwidth. The memoryFraction of a compute's time is memory bound, it stretches by
+// active / saturation once more than saturation ranks on the node are computing. The
+// node is processor shared: whenever a compute starts or ends the work left in every
+// other compute on the node is moved to the new stretch and its end is rescheduled
+// through the rank's handler. The ranks of a node are linked to its NIC with links
+// that are not cut, so they share one SST thread and one clock.
+class Contention {
+  public:
+    // moves the end of the rank's compute to delay from now
+    typedef std::function<void(SimTime_t delay)> Handler;
+
+    Contention( int jobId, int rank, int nodeId, double memoryFraction, int saturation, uint32_t verboseLevel, uint32_t verboseMask );
+
+    void setup( Handler handler ) { m_handler = handler; }
+
+    // returns how long a compute of ns takes with the ranks computing now, the rank
+    // counts as computing until end()
+    SimTime_t start( double ns, SimTime_t now );
+    void end( SimTime_t now );
+
+  private:
+    double stretch( int active ) {
+        return active > m_saturation ? 1 - m_memoryFraction + m_memoryFraction * active / m_saturation : 1;
+    }
+    // brings the work left in the node's computes up to now and moves their ends to the stretch of count computing
+    void reschedule( std::vector<Contention*>& active, int count, SimTime_t now );
+
+    Output  m_output;
+    int     m_nodeId;
+    double  m_memoryFraction;
+    int     m_saturation;
+    Handler m_handler;
+
+    // ns of uncontended work left as of m_since, done at 1 / m_stretch ns per ns
+    double      m_left;
+    SimTime_t   m_since;
+    double      m_stretch;
+
+    // ranks computing on each node
+    static std::map<int,std::vector<Contention*> > m_active;
+    static std::mutex           m_mutex;
+};
+
+}
+}
+
+#endif
@@ -28,9 +28,13 @@ const char* Convert::m_functionName[] = {
     FOREACH_FUNCTION(GENERATE_STRING)
 };
 
-Convert::Convert( Link* link, MP::Interface* mp, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask ): 
-	m_selfLink(link), m_mp(mp), m_jobId(jobId), m_rank(rank), m_type(Empty), m_reqNum(0),
-	initFunctor(Functor(this, &Convert::handleReturn, Init)),
+int Convert::numFunctions() {
+    return Ialltoall + 1;
+}
+
+Convert::Convert( Link* link, MP::Interface* mp, int jobId, int rank, const Features& features, uint32_t verboseLevel, uint32_t verboseMask ): 
+	m_type(Empty),
+	initFunctor(Functor(this, &Convert::handleInitReturn, 0)),
 	finiFunctor(Functor(this, &Convert::handleReturn, Finalize)),
 	sendFunctor(Functor(this, &Convert::handleReturn, Send)),
 	isendFunctor(Functor(this, &Convert::handleReturn, Isend)),
@@ -39,101 +43,1880 @@ Convert::Convert( Link* link, MP::Interface* mp, int jobId, int rank, uint32_t v
 	sendrecvFunctor(Functor(this, &Convert::handleReturn, SendRecv)),
 	sendrecvIrecvFunctor(Functor(this, &Convert::handleSendRecvIrecvReturn,0)),
 	sendrecvSendFunctor(Functor(this, &Convert::handleSendRecvSendReturn,0)),
-	waitallFunctor(Functor(this, &Convert::handleReturn, Waitall)),
 	waitFunctor(Functor(this, &Convert::handleReturn, Wait)),
+	waitallFunctor(Functor(this, &Convert::handleReturn, Waitall)),
+	testFunctor(Functor(this, &Convert::handleTestReturn, 0)),
+	testallFunctor(Functor(this, &Convert::handleTestallReturn, 0)),
+	waitanyFunctor(Functor(this, &Convert::handleWaitanyReturn, 0)),
+	waitsomeAnyFunctor(Functor(this, &Convert::handleWaitsomeAnyReturn, 0)),
+	waitsomeTestFunctor(Functor(this, &Convert::handleWaitsomeTestReturn, 0)),
+	pollFunctor(Functor(this, &Convert::handlePollReturn, 0)),
+	responsePostFunctor(Functor(this, &Convert::handleResponsePostReturn, 0)),
+	responseWaitFunctor(Functor(this, &Convert::handleResponseWaitReturn, 0)),
+	responseDrainFunctor(Functor(this, &Convert::handleResponseDrainReturn, 0)),
+	privateFunctor(Functor(this, &Convert::handlePrivateReturn, 0)),
 	allreduceFunctor(Functor(this, &Convert::handleReturn, Allreduce)),
-	barrierFunctor(Functor(this, &Convert::handleReturn, Barrier))
+	barrierFunctor(Functor(this, &Convert::handleReturn, Barrier)),
+	commSplitFunctor(Functor(this, &Convert::handleCommSplitReturn, 0)),
+	commCreateFunctor(Functor(this, &Convert::handleCommCreateReturn, 0)),
+	commFreeFunctor(Functor(this, &Convert::handleReturn, CommFree)),
+	flushFunctor(Functor(this, &Convert::handleFlushReturn, 0)),
+	batchFunctor(Functor(this, &Convert::handleBatchReturn, 0)),
+	batchInitFunctor(Functor(this, &Convert::handleBatchInitReturn, 0)),
+	batchRepostFunctor(Functor(this, &Convert::handleBatchRepostReturn, 0)),
+	batchTestFunctor(Functor(this, &Convert::handleBatchTestReturn, 0)),
+	batchWaitFunctor(Functor(this, &Convert::handleBatchWaitReturn, 0)),
+	collIsendFunctor(Functor(this, &Convert::handleCollIsendReturn, 0)),
+	collIrecvFunctor(Functor(this, &Convert::handleCollIrecvReturn, 0)),
+	collTestFunctor(Functor(this, &Convert::handleCollTestReturn, 0)),
+	collWaitFunctor(Functor(this, &Convert::handleCollWaitReturn, 0)),
+	collSendFunctor(Functor(this, &Convert::handleCollSendReturn, 0)),
+	collRecvFunctor(Functor(this, &Convert::handleCollRecvReturn, 0)),
+	m_selfLink(link), m_mp(mp), m_rank(rank), m_jobId(jobId), m_reqNum(0), m_opIndex(0), m_ffUntil(0), m_resumeAt(0),
+	m_checkpoint(features.checkpoint), m_sampler(features.sampler), m_commMatrix(features.commMatrix),
+	m_timeline(features.timeline), m_progress(features.progress), m_generator(NULL), m_initialized(false), m_bytesScale(1),
+	m_computeScale(1), m_finalStage(true), m_phases(features.phases), m_contention(features.contention), m_computing(false),
+	m_computeGen(0), m_fidelity(features.fidelity), m_modelRecv(false), m_histograms(features.histograms),
+	m_comms(features.comms), m_opStart(0), m_readyAt(0), m_pollGen(0), m_shm(features.shm), m_shmRecvLocal(false),
+	m_shmArrived(false), m_shmWaiting(false), m_shmReissue(false), m_agg(features.aggregator), m_aggThen(ThenIssue),
+	m_aggRecv(false), m_batchTested(false), m_shmem(features.shmem), m_shmemHeap(features.shmemHeap), m_operand(0),
+	m_fetched(0), m_operandValue(Hermes::Value::Long, &m_operand), m_fetchedValue(Hermes::Value::Long, &m_fetched),
+	m_collPosting(0), m_collIndex(0), m_collFlag(0), m_collProgressed(false), m_collPolling(false), m_watchAll(false),
+	m_waitReqs(NULL), m_waitAll(false), m_waitThen(NULL), m_collSendThen(NULL), m_responsePos(0), m_responseBase(0),
+	m_returnVal(0), m_returnType(0), m_allreduceResponse(false)
 {
 	g_verboseLevel[jobId] = verboseLevel;
 	g_verboseMask[jobId] = verboseMask;
     char buffer[100];
     snprintf(buffer,100,"@t:%d:%d:Convert::@p():@l ",jobId,m_rank);
     m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    m_tConv = Simulation::getSimulation()->getTimeLord()->getTimeConverter("1ns");
+
+    if ( m_checkpoint ) {
+        m_ffUntil = m_checkpoint->restartOp();
+        m_resumeAt = m_checkpoint->restartTime();
+    }
+    if ( m_shm ) {
+        m_shm->setup( rank, [=]( uint32_t id, int tag ) { shmArrived( id, tag ); } );
+    }
+    if ( m_contention ) {
+        m_contention->setup( [=]( SimTime_t delay ) {
+            m_selfLink->send( delay, new SwmEvent(SwmEvent::Type::ComputeDone, ++m_computeGen ) );
+        } );
+    }
+}
+
+// true if peer shares the node, messages to it and from it go through Shm
+bool Convert::shmPeer( SWM_COMM_ID comm_id, SWM_PEER peer ) {
+    if ( ! m_shm ) {
+        return false;
+    }
+    if ( (RankID) peer == AnySrc ) {
+        for ( int member : m_comms->members( comm_id ) ) {
+            if ( m_shm->local( member ) ) {
+                m_output.fatal(CALL_INFO,-1,"a receive from any source can't be matched on a communicator with ranks on the node\n");
+            }
+        }
+        return false;
+    }
+    return m_shm->local( m_comms->world( comm_id, peer ) );
+}
+
+// a message from a rank on the node matched a posted receive
+void Convert::shmArrived( uint32_t id, int tag ) {
+    if ( ShmBlocking == id ) {
+        m_resp[0].tag = tag;
+        m_shmArrived = true;
+        if ( m_shmWaiting && ! m_collPolling ) {
+            m_shmWaiting = false;
+            returnDone();
+        }
+        return;
+    }
+    setDoneResp( id, m_posted.at( id ).peer, tag );
+    m_doneReqs[id] = now();
+    if ( m_shmReissue ) {
+        m_shmReissue = false;
+        ++m_pollGen;
+        issueWork();
+    }
+}
+
+void Convert::poll( int generation ) {
+    if ( generation != m_pollGen ) {
+        return;
+    }
+    if ( m_shmReissue ) {
+        m_shmReissue = false;
+        issueWork();
+    } else if ( m_modelThen ) {
+        std::function<void()> then = m_modelThen;
+        m_modelThen = nullptr;
+        if ( m_collectives.empty() ) {
+            then();
+        } else {
+            progressCollectives( then );
+        }
+    } else if ( m_shmWaiting ) {
+        m_collPolling = true;
+        progressCollectives( [=]() {
+            m_collPolling = false;
+            if ( m_shmArrived ) {
+                m_shmWaiting = false;
+                returnDone();
+            } else if ( ! m_collectives.empty() ) {
+                schedulePoll();
+            }
+        } );
+    }
+}
+
+// none of the Hermes requests has completed, look again unless a message from the node comes first
+bool Convert::handlePollReturn( int retval, int type ) {
+    if ( m_flag ) {
+        return Waitany == m_type ? handleWaitanyReturn( retval, 0 ) : handleWaitsomeAnyReturn( retval, 0 );
+    }
+    m_shmReissue = true;
+    schedulePoll();
+    return false;
+}
+
+// complete a call whose messages didn't go through Hermes, after the responses they generate
+void Convert::returnDone() {
+    if ( ! startResponses( 0, m_type ) ) {
+        returnNow();
+    }
+}
+
+// the current call waits on a request whose message hasn't arrived, a batch is received,
+// a message from a rank on the node arrives on its own
+void Convert::waitPending( bool aggregated ) {
+    if ( aggregated ) {
+        recvBatch();
+    } else {
+        m_shmReissue = true;
+        if ( ! m_collectives.empty() || ! m_modelPosted.empty() ) {
+            schedulePoll();
+        }
+    }
+}
+
+// Waitany and Waitsome on messages from the node test their other requests, with none
+// of them the call is issued again when a message arrives
+void Convert::waitLocal() {
+    if ( m_req.empty() ) {
+        waitPending( false );
+        return;
+    }
+    m_mp->testany( m_req.size(), m_req.data(), &m_index, &m_flag, &m_resp[0], &pollFunctor );
+}
+
+void Convert::schedulePoll() {
+    m_selfLink->send( PollInterval, new SwmEvent(SwmEvent::Type::Poll, ++m_pollGen ) );
+}
+
+// a blocking receive from a rank on the node keeps the schedules in flight moving
+void Convert::waitShm() {
+    m_shmArrived = false;
+    m_shmWaiting = true;
+    if ( ! m_collectives.empty() ) {
+        schedulePoll();
+    }
+}
+
+bool Convert::handleInitReturn( int retval, int type ) {
+    m_newMembers = m_comms->members( 0 );
+    m_mp->comm_create( GroupWorld, m_newMembers.size(), m_newMembers.data(), &m_private, &privateFunctor );
+    return false;
+}
+
+bool Convert::handlePrivateReturn( int retval, int type ) {
+    if ( m_agg ) {
+        postBatch( &batchInitFunctor );
+        return false;
+    }
+    return initShmem();
+}
+
+bool Convert::handleBatchInitReturn( int retval, int type ) {
+    return initShmem();
+}
+
+// every rank allocates the symmetric heap, Init returns once all have
+bool Convert::initShmem() {
+    if ( ! m_shmem ) {
+        return handleReturn( 0, Init );
+    }
+    m_shmem->init( [=]( int ) {
+        m_shmem->malloc( &m_heap, m_shmemHeap, false, [=]( int ) {
+            m_shmem->malloc( &m_atomic, sizeof(long), true, [=]( int retval ) {
+                handleReturn( retval, Init );
+            } );
+        } );
+    } );
+    return false;
+}
+
+void Convert::checkRma() {
+    if ( ! m_shmem ) {
+        m_output.fatal(CALL_INFO,-1,"%s needs one-sided communication, set shmemHeap\n",m_functionName[m_type]);
+    }
+    if ( m_args.rma.pe < 0 || m_args.rma.pe >= m_comms->size( 0 ) ) {
+        m_output.fatal(CALL_INFO,-1,"%s to pe %d, there are %d\n",m_functionName[m_type],(int)m_args.rma.pe,m_comms->size( 0 ));
+    }
+    if ( ( Put == m_type || Get == m_type ) && (size_t) m_args.rma.bytes > m_shmemHeap ) {
+        m_output.fatal(CALL_INFO,-1,"%s of %d bytes doesn't fit the %zu byte shmemHeap\n",m_functionName[m_type],(int)m_args.rma.bytes,m_shmemHeap);
+    }
+}
+
+bool Convert::rmaPending( int len, uint32_t* req_ids ) {
+    for ( int i = 0; i < len; i++ ) {
+        auto iter = m_doneReqs.find( req_ids[i] );
+        if ( iter != m_doneReqs.end() && iter->second == RmaPending ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// a call on requests of non-blocking one-sided calls waits for them to complete first
+bool Convert::quietFirst() {
+    switch ( m_type ) {
+      case Wait:
+        return rmaPending( 1, &m_args.wait.req_id );
+      case Waitall:
+        return rmaPending( m_args.waitall.len, m_args.waitall.req_ids );
+      case Test:
+        return rmaPending( 1, &m_args.test.req_id );
+      case Testall:
+        return rmaPending( m_args.testall.len, m_args.testall.req_ids );
+      case Waitany:
+        return rmaPending( m_args.waitany.len, m_args.waitany.req_ids );
+      case Waitsome:
+        return rmaPending( m_args.waitsome.len, m_args.waitsome.req_ids );
+      default:
+        return false;
+    }
+}
+
+// SHMEM has no per call completion, a quiet completes every one-sided call the rank made
+void Convert::quiet() {
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"quiet\n");
+    m_shmem->quiet( [=]( int ) {
+        for ( auto& iter : m_doneReqs ) {
+            if ( RmaPending == iter.second ) {
+                iter.second = now();
+            }
+        }
+        issueWork();
+    } );
+}
+
+// calls that use Hermes in ways that can't also progress the schedules wait for them first
+bool Convert::drainsCollectives() {
+    switch ( m_type ) {
+      case Compute:
+      case Isend:
+      case Irecv:
+      case Send:
+      case Recv:
+      case SendRecv:
+      case Wait:
+      case Waitall:
+      case Waitany:
+      case Waitsome:
+      case Test:
+      case Testall:
+      case Iallreduce:
+      case Ibarrier:
+      case Ialltoall:
+        return false;
+      default:
+        return true;
+    }
+}
+
+// allreduce and barrier exchange with ranks 1, 2, 4 .. away, alltoall with each rank in turn
+int Convert::collRounds( const Collective& coll ) {
+    if ( Ialltoall == coll.type ) {
+        return coll.size - 1;
+    }
+    int rounds = 0;
+    while ( ( 1 << rounds ) < coll.size ) {
+        ++rounds;
+    }
+    return rounds;
+}
+
+// every member numbers its collectives on a communicator the same way, the tag keeps
+// schedules on different communicators between the same ranks apart
+uint32_t Convert::collTag( const Communicators::Members& members ) {
+    uint32_t hash = 0;
+    for ( auto rank : members ) {
+        hash = hash * 31 + rank;
+    }
+    uint32_t seq = m_collSeq[&members]++;
+    return ( ( hash & 0xfffff ) << 10 ) | ( seq & 0x3ff );
+}
+
+void Convert::startCollective() {
+    const Communicators::Members& members = m_comms->members( m_args.icoll.comm_id );
+    Collective coll;
+    coll.type = m_type;
+    coll.bytes = Ibarrier == m_type ? 0 : m_args.icoll.bytes;
+    coll.members = &members;
+    coll.me = m_comms->rank( m_args.icoll.comm_id );
+    coll.size = members.size();
+    coll.round = 0;
+    coll.outstanding = 0;
+    coll.tag = collTag( members );
+    uint32_t num = m_reqNum++;
+    *m_args.icoll.handle = num;
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"%s handle=%d bytes=%d tag=%#x\n",m_functionName[m_type],num,(int)coll.bytes,coll.tag);
+    if ( 0 == collRounds( coll ) ) {
+        addDoneReq( num, now() );
+        returnNow();
+        return;
+    }
+    addDoneReq( num, CollPending );
+    m_collectives[num] = coll;
+    m_collThen = [=]() { returnNow(); };
+    postRound( num );
+}
+
+void Convert::postRound( uint32_t num ) {
+    Collective& coll = m_collectives.at( num );
+    int dist = Ialltoall == coll.type ? coll.round + 1 : 1 << coll.round;
+    int to = ( *coll.members )[ ( coll.me + dist ) % coll.size ];
+    m_collPosting = num;
+    m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"handle=%d round=%d to=%d\n",num,coll.round,to);
+    Hermes::MemAddr addr(0,NULL);
+    m_mp->isend( addr, coll.bytes, CHAR, to, coll.tag, m_private, &m_collPostReq, &collIsendFunctor );
+}
+
+bool Convert::handleCollIsendReturn( int retval, int type ) {
+    Collective& coll = m_collectives.at( m_collPosting );
+    int dist = Ialltoall == coll.type ? coll.round + 1 : 1 << coll.round;
+    int from = ( *coll.members )[ ( coll.me - dist % coll.size + coll.size ) % coll.size ];
+    m_collReq.push_back( m_collPostReq );
+    m_collOwner.push_back( m_collPosting );
+    Hermes::MemAddr addr(0,NULL);
+    m_mp->irecv( addr, coll.bytes, CHAR, from, coll.tag, m_private, &m_collPostReq, &collIrecvFunctor );
+    return false;
+}
+
+bool Convert::handleCollIrecvReturn( int retval, int type ) {
+    m_collReq.push_back( m_collPostReq );
+    m_collOwner.push_back( m_collPosting );
+    m_collectives.at( m_collPosting ).outstanding = 2;
+    m_collThen();
+    return false;
+}
+
+// a request of a round completed, the next round is posted once both have
+void Convert::roundDone( size_t index ) {
+    uint32_t num = m_collOwner[index];
+    m_collReq.erase( m_collReq.begin() + index );
+    m_collOwner.erase( m_collOwner.begin() + index );
+    Collective& coll = m_collectives.at( num );
+    if ( --coll.outstanding ) {
+        m_collThen();
+        return;
+    }
+    if ( ++coll.round < collRounds( coll ) ) {
+        postRound( num );
+        return;
+    }
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"%s handle=%d done\n",m_functionName[coll.type],num);
+    m_doneReqs[num] = now();
+    m_collectives.erase( num );
+    m_collThen();
+}
+
+// test the round requests until none has completed, then continue with then
+void Convert::progressCollectives( std::function<void()> then ) {
+    m_progressThen = then;
+    m_collThen = [=]() { testRounds(); };
+    testRounds();
+}
+
+void Convert::testRounds() {
+    if ( m_collReq.empty() ) {
+        m_progressThen();
+        return;
+    }
+    m_mp->testany( m_collReq.size(), m_collReq.data(), &m_collIndex, &m_collFlag, &m_collResp, &collTestFunctor );
+}
+
+bool Convert::handleCollTestReturn( int retval, int type ) {
+    if ( m_collFlag ) {
+        roundDone( m_collIndex );
+    } else {
+        m_progressThen();
+    }
+    return false;
+}
+
+// wait for count of reqs, all of them or any one, or for the collectives in m_collWatch,
+// progressing the schedules in flight. With all each response goes to m_resp[i], otherwise
+// the one to m_resp[0] and its index to m_index, then is called when the wait is done.
+// The call is issued again instead once the watched collectives are done.
+void Convert::collWait( MessageRequest* reqs, size_t count, bool all, Functor* then ) {
+    m_waitReqs = reqs;
+    m_waitAll = all;
+    m_waitThen = then;
+    m_waitLeft.clear();
+    for ( size_t i = 0; i < count; i++ ) {
+        m_waitLeft.push_back( i );
+    }
+    m_collThen = [=]() { collWaitNext(); };
+    collWaitNext();
+}
+
+void Convert::collWaitNext() {
+    if ( ! m_collWatch.empty() ) {
+        size_t done = 0;
+        for ( auto num : m_collWatch ) {
+            done += m_collectives.find( num ) == m_collectives.end();
+        }
+        if ( m_watchAll ? done == m_collWatch.size() : done > 0 ) {
+            m_collWatch.clear();
+            issueWork();
+            return;
+        }
+    }
+    m_waitSet.clear();
+    for ( auto i : m_waitLeft ) {
+        m_waitSet.push_back( m_waitReqs[i] );
+    }
+    m_waitSet.insert( m_waitSet.end(), m_collReq.begin(), m_collReq.end() );
+    m_mp->waitany( m_waitSet.size(), m_waitSet.data(), &m_collIndex, &m_collResp, &collWaitFunctor );
+}
+
+bool Convert::handleCollWaitReturn( int retval, int type ) {
+    if ( (size_t) m_collIndex >= m_waitLeft.size() ) {
+        roundDone( m_collIndex - m_waitLeft.size() );
+        return false;
+    }
+    size_t i = m_waitLeft[m_collIndex];
+    m_waitLeft.erase( m_waitLeft.begin() + m_collIndex );
+    m_collWatch.clear();
+    if ( m_waitAll ) {
+        m_resp[i] = m_collResp;
+        if ( ! m_waitLeft.empty() ) {
+            collWaitNext();
+            return false;
+        }
+    } else {
+        m_resp[0] = m_collResp;
+        m_index = i;
+    }
+    (*m_waitThen)( retval );
+    return false;
+}
+
+// wait for the collectives among req_ids, for all of them or for any one
+void Convert::watchCollectives( int len, uint32_t* req_ids, bool all ) {
+    m_collWatch.clear();
+    for ( int i = 0; i < len; i++ ) {
+        if ( collPendingReq( req_ids[i] ) ) {
+            m_collWatch.push_back( req_ids[i] );
+        }
+    }
+    m_watchAll = all;
+}
+
+bool Convert::handleCollSendReturn( int retval, int type ) {
+    m_resp.resize( 1 );
+    collWait( &m_collSendReq, 1, false, m_collSendThen );
+    return false;
+}
+
+bool Convert::handleCollRecvReturn( int retval, int type ) {
+    collWait( m_req.data(), 1, false, &recvFunctor );
+    return false;
+}
+
+// small sends are held until a call that could wait on them, or until they are due
+bool Convert::flushFirst() {
+    if ( m_agg->empty() ) {
+        return false;
+    }
+    switch ( m_type ) {
+      case Compute:
+      case Irecv:
+        return m_agg->due( now() );
+      case Send:
+      case Isend:
+        if ( m_agg->small( m_args.send.bytes ) && ! shmPeer( m_args.send.comm_id, m_args.send.peer ) ) {
+            return m_agg->due( now() );
+        }
+        return true;
+      default:
+        return true;
+    }
+}
+
+void Convert::aggregate( SWM_PEER peer, SWM_COMM_ID comm_id, SWM_TAG tag, SWM_BYTES bytes ) {
+    Aggregator::Message msg = { m_comms->rank( comm_id ), &m_comms->members( comm_id ), tag, (uint64_t) bytes };
+    m_agg->add( m_comms->world( comm_id, peer ), msg, now() );
+}
+
+void Convert::flushBatch() {
+    int dst;
+    uint64_t bytes;
+    m_agg->flush( &dst, &bytes );
+    Hermes::MemAddr addr(0,NULL);
+    m_mp->send( addr, bytes, CHAR, dst, AggTag, m_private, &flushFunctor );
+}
+
+bool Convert::handleFlushReturn( int retval, int type ) {
+    if ( ! m_agg->empty() ) {
+        flushBatch();
+        return false;
+    }
+    AggThen then = m_aggThen;
+    m_aggThen = ThenIssue;
+    switch ( then ) {
+      case ThenIssue:
+        issueWork();
+        break;
+      case ThenReturn:
+        returnDone();
+        break;
+      case ThenSendRecv:
+        handleSendRecvSendReturn( 0, 0 );
+        break;
+    }
+    return false;
+}
+
+void Convert::postBatch( Functor* functor ) {
+    Hermes::MemAddr addr(0,NULL);
+    m_mp->irecv( addr, m_agg->batchBytes(), CHAR, AnySrc, AggTag, m_private, &m_batchReq, functor );
+}
+
+void Convert::testBatch() {
+    m_resp.resize( 1 );
+    m_mp->test( m_batchReq, &m_flag, &m_resp[0], &batchTestFunctor );
+}
+
+void Convert::recvBatch() {
+    if ( ! m_collectives.empty() ) {
+        m_resp.resize( 1 );
+        collWait( &m_batchReq, 1, false, &batchWaitFunctor );
+        return;
+    }
+    m_mp->wait( m_batchReq, &m_batchResp, &batchFunctor );
+}
+
+// a wait that included m_batchReq returned it at the index after the call's own requests
+bool Convert::batchArrived() {
+    m_batchResp = m_resp[0];
+    return handleBatchReturn( 0, 0 );
+}
+
+// the posted Irecvs get the batch's messages first, then the current call is tried again
+bool Convert::handleBatchReturn( int retval, int type ) {
+    m_agg->unpack( m_batchResp.src );
+    uint32_t id;
+    Aggregator::Message msg;
+    while ( m_agg->matchPosted( &id, &msg ) ) {
+        setDoneResp( id, msg.src, msg.tag );
+        m_doneReqs[id] = now();
+    }
+    postBatch( &batchRepostFunctor );
+    return false;
+}
+
+bool Convert::handleBatchWaitReturn( int retval, int type ) {
+    return batchArrived();
+}
+
+bool Convert::handleBatchTestReturn( int retval, int type ) {
+    if ( m_flag ) {
+        m_batchResp = m_resp[0];
+        return handleBatchReturn( 0, 0 );
+    }
+    m_batchTested = true;
+    issueWork();
+    return false;
+}
+
+bool Convert::handleBatchRepostReturn( int retval, int type ) {
+    if ( SendRecv == m_type ) {
+        handleSendRecvSendReturn( 0, 0 );
+    } else {
+        issueWork();
+    }
+    return false;
+}
+
+bool Convert::handleSendRecvIrecvReturn( int retval, int type) {
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"send peer=%d comm_id=%d tag=%#x bytes=%d\n",
+                 (int)m_args.sendrecv.sendpeer,(int)m_args.sendrecv.comm_id,(int)m_args.sendrecv.sendtag,(int)m_args.sendrecv.sendbytes);
+    Hermes::MemAddr addr(0,NULL);
+    if ( analyticPeer( m_args.sendrecv.comm_id, m_args.sendrecv.sendpeer ) ) {
+        m_readyAt = now() + model().pt2pt( m_args.sendrecv.sendbytes );
+        return handleSendRecvSendReturn( 0, 0 );
+    }
+    expectResponse( m_args.sendrecv.sendpeer, m_args.sendrecv.comm_id, m_args.sendrecv.sendtag, m_args.sendrecv.pktrspbytes );
+    if ( shmPeer( m_args.sendrecv.comm_id, m_args.sendrecv.sendpeer ) ) {
+        m_readyAt = now() + m_shm->send( m_comms->world( m_args.sendrecv.comm_id, m_args.sendrecv.sendpeer ), &m_comms->members( m_args.sendrecv.comm_id ),
+                m_args.sendrecv.sendtag, m_args.sendrecv.sendbytes );
+        return handleSendRecvSendReturn( 0, 0 );
+    }
+    if ( m_agg && m_agg->small( m_args.sendrecv.sendbytes ) ) {
+        aggregate( m_args.sendrecv.sendpeer, m_args.sendrecv.comm_id, m_args.sendrecv.sendtag, m_args.sendrecv.sendbytes );
+        m_aggThen = ThenSendRecv;
+        flushBatch();
+        return false;
+    }
+    if ( ! m_collectives.empty() ) {
+        m_collSendThen = &sendrecvSendFunctor;
+        m_mp->isend( addr, m_args.sendrecv.sendbytes, CHAR, m_args.sendrecv.sendpeer, m_args.sendrecv.sendtag, hermesComm( m_args.sendrecv.comm_id ),
+                &m_collSendReq, &collSendFunctor );
+        return false;
+    }
+	m_mp->send( addr, m_args.sendrecv.sendbytes, CHAR, m_args.sendrecv.sendpeer, m_args.sendrecv.sendtag, hermesComm( m_args.sendrecv.comm_id ), &sendrecvSendFunctor );
+    return false;
+}
+
+bool Convert::handleSendRecvSendReturn( int retval, int type) {
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"wait\n");
+    m_resp.resize( 1 );
+    if ( m_modelRecv ) {
+        m_resp[0].src = m_args.sendrecv.recvpeer;
+        m_resp[0].tag = m_args.sendrecv.recvtag;
+        SimTime_t done;
+        if ( ! modelArrival( m_args.sendrecv.comm_id, m_args.sendrecv.recvpeer, m_args.sendrecv.recvtag, m_args.sendrecv.sendbytes,
+                m_opStart, &done ) ) {
+            m_modelThen = [=]() { handleSendRecvSendReturn( 0, 0 ); };
+            schedulePoll();
+            return false;
+        }
+        m_readyAt = std::max( m_readyAt, done );
+        returnDone();
+        return false;
+    }
+    if ( m_shmRecvLocal ) {
+        if ( m_shmArrived ) {
+            returnDone();
+        } else {
+            waitShm();
+        }
+        return false;
+    }
+    if ( m_aggRecv ) {
+        Aggregator::Message msg;
+        if ( m_agg->match( m_args.sendrecv.recvpeer, &m_comms->members( m_args.sendrecv.comm_id ), m_args.sendrecv.recvtag, &msg ) ) {
+            m_resp[0].src = msg.src;
+            m_resp[0].tag = msg.tag;
+            returnDone();
+        } else {
+            recvBatch();
+        }
+        return false;
+    }
+    if ( ! m_collectives.empty() ) {
+        collWait( m_req.data(), 1, false, &sendrecvFunctor );
+        return false;
+    }
+	m_mp->wait( m_req[0], &m_resp[0], &sendrecvFunctor);
+    return false;
+}
+
+// test the request m_pending[m_pendingPos] of the current request array
+void Convert::testPending( Functor* functor ) {
+    uint32_t id = m_reqIds[ m_pending[m_pendingPos] ];
+    m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"test id=%d\n",id);
+    m_req.resize( 1 );
+    m_resp.resize( 1 );
+    m_req[0] = *findMsgReq( id );
+    m_mp->test( m_req[0], &m_flag, &m_resp[0], functor );
+}
+
+bool Convert::handleTestReturn( int retval, int type) {
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"test id=%d flag=%d\n",m_args.test.req_id,m_flag);
+    *m_args.test.flag = m_flag;
+    if ( m_flag ) {
+        freeMsgReq( m_args.test.req_id );
+        completed( m_args.test.req_id, &m_resp[0] );
+    }
+    return handleReturn( retval, Test );
+}
+
+bool Convert::handleTestallReturn( int retval, int type) {
+    if ( m_flag ) {
+        uint32_t id = m_reqIds[ m_pending[m_pendingPos] ];
+        freeMsgReq( id );
+        completed( id, &m_resp[0] );
+        addDoneReq( id, now() );
+    }
+    if ( ++m_pendingPos < m_pending.size() ) {
+        testPending( &testallFunctor );
+        return false;
+    }
+
+    int flag = testallDone( m_args.testall.len, m_args.testall.req_ids );
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"testall flag=%d\n",flag);
+    *m_args.testall.flag = flag;
+    return handleReturn( retval, Testall );
+}
+
+// true if all requests are done, in which case they are retired
+int Convert::testallDone( int len, uint32_t* req_ids ) {
+    for ( int i = 0; i < len; i++ ) {
+        if ( ! isDoneReq( req_ids[i] ) ) {
+            return 0;
+        }
+    }
+    for ( int i = 0; i < len; i++ ) {
+        retireDoneReq( req_ids[i] );
+    }
+    return 1;
+}
+
+bool Convert::handleWaitanyReturn( int retval, int type) {
+    if ( m_index == (int) m_pending.size() ) {
+        return batchArrived();
+    }
+    int index = m_pending[m_index];
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"waitany index=%d\n",index);
+    freeMsgReq( m_args.waitany.req_ids[index] );
+    completed( m_args.waitany.req_ids[index], &m_resp[0] );
+    *m_args.waitany.index = index;
+    return handleReturn( retval, Waitany );
+}
+
+// Waitsome blocks in a Hermes waitany and then tests the remaining requests so
+// everything that has completed by then is returned
+bool Convert::handleWaitsomeAnyReturn( int retval, int type) {
+    if ( m_index == (int) m_pending.size() ) {
+        return batchArrived();
+    }
+    int index = m_pending[m_index];
+    freeMsgReq( m_args.waitsome.req_ids[index] );
+    completed( m_args.waitsome.req_ids[index], &m_resp[0] );
+    m_args.waitsome.indices[ (*m_args.waitsome.outcount)++ ] = index;
+
+    m_pending.erase( m_pending.begin() + m_index );
+    m_pendingPos = 0;
+    if ( ! m_pending.empty() ) {
+        testPending( &waitsomeTestFunctor );
+        return false;
+    }
+    return handleReturn( retval, Waitsome );
+}
+
+bool Convert::handleWaitsomeTestReturn( int retval, int type) {
+    if ( m_flag ) {
+        int index = m_pending[m_pendingPos];
+        freeMsgReq( m_args.waitsome.req_ids[index] );
+        completed( m_args.waitsome.req_ids[index], &m_resp[0] );
+        m_args.waitsome.indices[ (*m_args.waitsome.outcount)++ ] = index;
+    }
+    if ( ++m_pendingPos < m_pending.size() ) {
+        testPending( &waitsomeTestFunctor );
+        return false;
+    }
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"waitsome outcount=%d\n",*m_args.waitsome.outcount);
+    return handleReturn( retval, Waitsome );
+}
+
+// complete the current call without going through Hermes, at m_readyAt if that is later
+void Convert::returnNow() {
+    SimTime_t now = this->now();
+    SimTime_t delay = m_readyAt > now ? m_readyAt - now : 0;
+    m_readyAt = 0;
+    m_selfLink->send( delay, new SwmEvent(SwmEvent::Type::MP_Returned, 0, m_type ) );
+}
+
+bool Convert::handleReturn( int retval, int type) {
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"%s returned\n",m_functionName[type],retval);
+    if ( startResponses( retval, type ) ) {
+        return false;
+    }
+    m_selfLink->send( new SwmEvent(SwmEvent::Type::MP_Returned, retval, type ) );
+    return false;
+}
+
+// the sender of a request leaves the size of the response for the receiver
+void Convert::expectResponse( int peer, int comm, uint32_t tag, SWM_BYTES bytes ) {
+    Responses::expect( m_jobId, m_rank, m_comms->world( comm, peer ), &m_comms->members( comm ), tag, bytes );
+}
+
+void Convert::recvResponse( int peer, int comm, SWM_BYTES bytes ) {
+    if ( bytes ) {
+        Response response = { false, m_comms->world( comm, peer ), (uint64_t) bytes };
+        m_responses.push_back( response );
+    }
+}
+
+// a request arrived, answer it if its sender expects a response
+void Convert::recvCompleted( int peer, int comm, uint32_t tag, MessageResponse* resp ) {
+    if ( (RankID) peer == AnySrc ) {
+        peer = resp->src;
+    }
+    if ( tag == AnyTag ) {
+        tag = resp->tag;
+    }
+    uint64_t bytes;
+    int src = m_comms->world( comm, peer );
+    if ( Responses::take( m_jobId, src, m_rank, &m_comms->members( comm ), tag, bytes ) && bytes ) {
+        Response response = { true, src, bytes };
+        m_responses.push_back( response );
+    }
+}
+
+// a request issued to Hermes completed
+void Convert::completed( uint32_t num, MessageResponse* resp ) {
+    if ( m_histograms && resp ) {
+        m_histograms->complete( num, now(), true );
+    }
+    auto iter = m_posted.find( num );
+    if ( iter == m_posted.end() ) {
+        return;
+    }
+    Posted& posted = iter->second;
+    // requests that completed outside Hermes have no MessageResponse
+    MessageResponse done;
+    if ( NULL == resp ) {
+        done.src = posted.peer;
+        done.tag = posted.tag;
+        resp = &done;
+    }
+    auto doneResp = m_doneResp.find( num );
+    if ( doneResp != m_doneResp.end() ) {
+        done = doneResp->second;
+        resp = &done;
+        m_doneResp.erase( doneResp );
+    }
+    if ( posted.send ) {
+        recvResponse( posted.peer, posted.comm, posted.rspBytes );
+    } else {
+        recvCompleted( posted.peer, posted.comm, posted.tag, resp );
+    }
+    m_posted.erase( iter );
+}
+
+// Collects the responses the call that just completed generates and, if there are any,
+// sends and receives them before the call returns to the workload. They are all posted
+// and then waited for together so ranks answering each other can't deadlock. The
+// response to an allreduce is a second allreduce of rspbytes.
+bool Convert::startResponses( int retval, int type ) {
+    switch ( type ) {
+      case Send:
+        recvResponse( m_args.send.peer, m_args.send.comm_id, m_args.send.pktrspbytes );
+        break;
+      case Recv:
+        recvCompleted( m_args.recv.peer, m_args.recv.comm_id, m_args.recv.tag, &m_resp[0] );
+        break;
+      case SendRecv:
+        recvResponse( m_args.sendrecv.sendpeer, m_args.sendrecv.comm_id, m_args.sendrecv.pktrspbytes );
+        recvCompleted( m_args.sendrecv.recvpeer, m_args.sendrecv.comm_id, m_args.sendrecv.recvtag, &m_resp[0] );
+        break;
+      case Wait:
+        completed( m_args.wait.req_id, &m_resp[0] );
+        break;
+      case Waitall:
+        for ( size_t i = 0; i < m_waitIds.size(); i++ ) {
+            completed( m_waitIds[i], m_respPtr[i] );
+        }
+        for ( size_t i = 0; i < m_doneIds.size(); i++ ) {
+            completed( m_doneIds[i], NULL );
+        }
+        m_waitIds.clear();
+        m_doneIds.clear();
+        break;
+      case Allreduce:
+        if ( m_allreduceResponse ) {
+            m_allreduceResponse = false;
+        } else if ( m_args.allreduce.rspbytes ) {
+            m_allreduceResponse = true;
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"allreduce response bytes=%d\n",m_args.allreduce.rspbytes);
+            Hermes::MemAddr addr(0,NULL);
+            m_mp->allreduce( addr, addr, m_args.allreduce.rspbytes, CHAR, NOP, hermesComm( m_args.allreduce.comm_id ), &allreduceFunctor );
+            return true;
+        }
+        break;
+      default:
+        break;
+    }
+    if ( m_responses.empty() ) {
+        return false;
+    }
+
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"%s has %zu responses\n",m_functionName[type],m_responses.size());
+    m_returnVal = retval;
+    m_returnType = type;
+    m_responsePos = 0;
+    m_responseBase = m_responseReq.size();
+    m_responseReq.resize( m_responseBase + m_responses.size() );
+    postResponse();
+    return true;
+}
+
+void Convert::postResponse() {
+    Response& response = m_responses[m_responsePos];
+    MessageRequest* req = &m_responseReq[m_responseBase + m_responsePos];
+    Hermes::MemAddr addr(0,NULL);
+    if ( response.send ) {
+        m_mp->isend( addr, response.bytes, CHAR, response.peer, ResponseTag, m_private, req, &responsePostFunctor );
+    } else {
+        m_mp->irecv( addr, response.bytes, CHAR, response.peer, ResponseTag, m_private, req, &responsePostFunctor );
+    }
+}
+
+// a polling rank would stall on every response if Test waited for them
+bool Convert::handleResponsePostReturn( int retval, int type ) {
+    if ( ++m_responsePos < m_responses.size() ) {
+        postResponse();
+        return false;
+    }
+    m_responses.clear();
+    if ( Test == m_returnType || Testall == m_returnType ) {
+        m_selfLink->send( new SwmEvent(SwmEvent::Type::MP_Returned, m_returnVal, m_returnType ) );
+        return false;
+    }
+    waitResponses( &responseWaitFunctor );
+    return false;
+}
+
+void Convert::waitResponses( Functor* functor ) {
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"wait for %zu responses\n",m_responseReq.size());
+    m_responseResp.resize( m_responseReq.size() );
+    m_responseRespPtr.resize( m_responseReq.size() );
+    for ( size_t i = 0; i < m_responseReq.size(); i++ ) {
+        m_responseRespPtr[i] = &m_responseResp[i];
+    }
+    m_mp->waitall( m_responseReq.size(), m_responseReq.data(), m_responseRespPtr.data(), functor );
+}
+
+bool Convert::handleResponseWaitReturn( int retval, int type ) {
+    m_responseReq.clear();
+    m_selfLink->send( new SwmEvent(SwmEvent::Type::MP_Returned, m_returnVal, m_returnType ) );
+    return false;
+}
+
+bool Convert::handleResponseDrainReturn( int retval, int type ) {
+    m_responseReq.clear();
+    leave();
+    return false;
+}
+
+// responses left outstanding by Test and Testall complete before the rank leaves
+void Convert::leave() {
+    if ( ! m_responseReq.empty() ) {
+        waitResponses( &responseDrainFunctor );
+    } else if ( m_shmem ) {
+        m_shmem->finalize( [=]( int ) { m_mp->fini( &finiFunctor ); } );
+    } else {
+        m_mp->fini( &finiFunctor );
+    }
+}
+
+// every member of the parent has left its color and key once the barrier on the parent returns
+bool Convert::handleCommSplitReturn( int retval, int type ) {
+    createComm( m_comms->split( m_args.comm.comm_id ) );
+    return false;
+}
+
+// Hermes builds a communicator from world ranks, ranks with color -1 don't get one
+void Convert::createComm( const Communicators::Members& members ) {
+    m_newMembers = members;
+    if ( m_newMembers.empty() ) {
+        *m_args.comm.newcomm = SWM_COMM_NULL;
+        returnNow();
+        return;
+    }
+    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"create size=%zu\n",m_newMembers.size());
+    m_mp->comm_create( GroupWorld, m_newMembers.size(), m_newMembers.data(), &m_newComm, &commCreateFunctor );
+}
+
+bool Convert::handleCommCreateReturn( int retval, int type ) {
+    *m_args.comm.newcomm = m_comms->add( m_newComm, m_newMembers );
+    m_selfLink->send( new SwmEvent(SwmEvent::Type::MP_Returned, retval, m_type ) );
+    return false;
+}
+
+void Convert::MP_returned( int retval, int  type) {
+	m_output.debug(CALL_INFO, 3, SWM_CONVERT_DBG_MASK,"thread=%" PRIx64 " %s retval=%d\n",std::this_thread::get_id(),m_functionName[type],retval);
+    opDone();
+    nextWork();
+    doWork();
+}
+
+void Convert::computeDone( int generation ) {
+    if ( generation == m_computeGen ) {
+        MP_returned( 0, Compute );
+    }
+}
+
+// called when the current call completes, before the workload is released
+void Convert::opDone() {
+    m_readyAt = 0;
+    if ( m_computing ) {
+        m_contention->end( now() );
+        m_computing = false;
+    }
+    if ( m_timeline ) {
+        recordTimeline();
+    }
+    if ( m_phases ) {
+        recordPhase();
+    }
+    if ( m_histograms ) {
+        recordHistogram();
+    }
+    if ( m_checkpoint && atSyncPoint() ) {
+        m_checkpoint->sync( m_opIndex, now() );
+    }
+}
+
+void Convert::recordTimeline() {
+    SimTime_t now = this->now();
+    switch ( m_type ) {
+      case Compute:
+        m_timeline->record( m_type, Timeline::Compute, m_opStart, now, -1, 0 );
+        break;
+      case Send:
+        m_timeline->record( m_type, Timeline::Blocking, m_opStart, now, m_args.send.peer, m_args.send.bytes );
+        break;
+      case Recv:
+        m_timeline->record( m_type, Timeline::Blocking, m_opStart, now, m_args.recv.peer, m_args.recv.bytes );
+        break;
+      case SendRecv:
+        m_timeline->record( m_type, Timeline::Blocking, m_opStart, now, m_args.sendrecv.sendpeer, m_args.sendrecv.sendbytes );
+        break;
+      case Isend:
+        m_timeline->record( m_type, Timeline::Post, m_opStart, now, m_args.send.peer, m_args.send.bytes );
+        break;
+      case Put:
+      case Get:
+        m_timeline->record( m_type, m_args.rma.handle ? Timeline::Post : Timeline::Blocking, m_opStart, now,
+                m_args.rma.pe, m_args.rma.bytes );
+        break;
+      case FetchAdd:
+        m_timeline->record( m_type, Timeline::Blocking, m_opStart, now, m_args.rma.pe, sizeof(long) );
+        break;
+      case Iallreduce:
+      case Ibarrier:
+      case Ialltoall:
+        m_timeline->record( m_type, Timeline::Post, m_opStart, now, -1, m_args.icoll.bytes );
+        break;
+      case Irecv:
+        m_timeline->record( m_type, Timeline::Post, m_opStart, now, m_args.recv.peer, m_args.recv.bytes );
+        break;
+      case Wait:
+      case Waitall:
+      case Test:
+      case Testall:
+      case Waitany:
+      case Waitsome:
+        m_timeline->record( m_type, Timeline::Wait, m_opStart, now, -1, 0 );
+        break;
+      case Allreduce:
+        m_timeline->record( m_type, Timeline::Collective, m_opStart, now, -1, m_args.allreduce.bytes );
+        break;
+      case Barrier:
+        m_timeline->record( m_type, Timeline::Collective, m_opStart, now, -1, 0 );
+        break;
+      default:
+        m_timeline->record( m_type, Timeline::Other, m_opStart, now, -1, 0 );
+        break;
+    }
+}
+
+// blocking calls are recorded when they return, requests are only posted here and end
+// when they complete
+void Convert::recordHistogram() {
+    SimTime_t now = this->now();
+    switch ( m_type ) {
+      case Send:
+        m_histograms->record( m_type, m_args.send.bytes, m_opStart, now );
+        break;
+      case Recv:
+        m_histograms->record( m_type, m_args.recv.bytes, m_opStart, now );
+        break;
+      case SendRecv:
+        m_histograms->record( m_type, m_args.sendrecv.sendbytes, m_opStart, now );
+        break;
+      case Allreduce:
+        m_histograms->record( m_type, m_args.allreduce.bytes, m_opStart, now );
+        break;
+      case FetchAdd:
+        m_histograms->record( m_type, sizeof(long), m_opStart, now );
+        break;
+      case Barrier:
+      case Fence:
+        m_histograms->record( m_type, 0, m_opStart, now );
+        break;
+      case Put:
+      case Get:
+        if ( m_args.rma.handle ) {
+            m_histograms->post( *m_args.rma.handle, m_type, m_args.rma.bytes, m_opStart );
+        } else {
+            m_histograms->record( m_type, m_args.rma.bytes, m_opStart, now );
+        }
+        break;
+      case Isend:
+        m_histograms->post( *m_args.send.handle, m_type, m_args.send.bytes, m_opStart );
+        break;
+      case Irecv:
+        m_histograms->post( *m_args.recv.handle, m_type, m_args.recv.bytes, m_opStart );
+        break;
+      case Iallreduce:
+      case Ibarrier:
+      case Ialltoall:
+        m_histograms->post( *m_args.icoll.handle, m_type, m_args.icoll.bytes, m_opStart );
+        break;
+      default:
+        break;
+    }
+}
+
+// time blocked in communication and bytes sent, Isend and Irecv only post
+void Convert::recordPhase() {
+    SimTime_t time = now() - m_opStart;
+    switch ( m_type ) {
+      case Send:
+        m_phases->record( time, m_args.send.bytes );
+        break;
+      case Isend:
+        m_phases->record( 0, m_args.send.bytes );
+        break;
+      case SendRecv:
+        m_phases->record( time, m_args.sendrecv.sendbytes );
+        break;
+      case Allreduce:
+        m_phases->record( time, m_args.allreduce.bytes );
+        break;
+      case Put:
+        m_phases->record( m_args.rma.handle ? 0 : time, m_args.rma.bytes );
+        break;
+      case Get:
+        m_phases->record( m_args.rma.handle ? 0 : time, 0 );
+        break;
+      case FetchAdd:
+        m_phases->record( time, sizeof(long) );
+        break;
+      case Fence:
+        m_phases->record( time, 0 );
+        break;
+      case Iallreduce:
+      case Ibarrier:
+      case Ialltoall:
+        m_phases->record( 0, m_args.icoll.bytes );
+        break;
+      case Recv:
+      case Barrier:
+      case Wait:
+      case Waitall:
+      case Test:
+      case Testall:
+      case Waitany:
+      case Waitsome:
+        m_phases->record( time, 0 );
+        break;
+      default:
+        break;
+    }
 }
 
-bool Convert::handleSendRecvIrecvReturn( int retval, int type) {
-    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"send peer=%d comm_id=%d tag=%#x bytes=%d\n",
-                 (int)m_args.sendrecv.sendpeer,(int)m_args.sendrecv.comm_id,(int)m_args.sendrecv.sendtag,(int)m_args.sendrecv.sendbytes);
-    Hermes::MemAddr addr(0,NULL);
-	m_mp->send( addr, m_args.sendrecv.sendbytes, CHAR, m_args.sendrecv.sendpeer, m_args.sendrecv.sendtag, m_args.sendrecv.comm_id, &sendrecvSendFunctor );
-    return false;
+// a collective on the world communicator with nothing outstanding is a point every rank passes in the same order
+bool Convert::atSyncPoint() {
+    if ( ! m_msgReqMap.empty() || ! m_doneReqs.empty() ) {
+        return false;
+    }
+    return ( Allreduce == m_type && GroupWorld == (Communicator) m_args.allreduce.comm_id ) ||
+           ( Barrier == m_type && GroupWorld == (Communicator) m_args.barrier.comm_id );
 }
 
-bool Convert::handleSendRecvSendReturn( int retval, int type) {
-    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"wait\n");
-    m_resp.resize( 1 );
-	m_mp->wait( m_req[0], &m_resp[0], &sendrecvFunctor);
-    return false;
+// Hermes' MP interface has no per message virtual channel or routing type, say once per
+// process that the workload asks for them
+void Convert::dropHints() {
+    bool hints = false;
+    switch ( m_type ) {
+      case Send:
+      case Isend:
+        hints = m_args.send.reqvc || m_args.send.rspvc || m_args.send.reqrt || m_args.send.rsprt;
+        break;
+      case SendRecv:
+        hints = m_args.sendrecv.sendreqvc || m_args.sendrecv.sendrspvc || m_args.sendrecv.reqrt || m_args.sendrecv.rsprt;
+        break;
+      case Allreduce:
+        hints = m_args.allreduce.sendreqvc || m_args.allreduce.sendrspvc || m_args.allreduce.reqrt || m_args.allreduce.rsprt;
+        break;
+      case Barrier:
+        hints = m_args.barrier.reqvc || m_args.barrier.rspvc || m_args.barrier.reqrt || m_args.barrier.rsprt;
+        break;
+      default:
+        break;
+    }
+    if ( hints ) {
+        static std::once_flag once;
+        std::call_once( once, [&]{
+            m_output.output("%s asks for a virtual channel or routing type, they are not modeled and the NIC's defaults are used\n",
+                    m_functionName[m_type]);
+        } );
+    }
 }
 
-bool Convert::handleReturn( int retval, int type) {
-    m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"%s returned\n",m_functionName[type],retval);
-    m_selfLink->send( new SwmEvent(SwmEvent::Type::MP_Returned, retval, type ) );
-    return false;
+bool Convert::polls() {
+    return Test == m_type || Testall == m_type || Waitsome == m_type;
 }
 
-void Convert::MP_returned( int retval, int  type) {
-	m_output.debug(CALL_INFO, 3, SWM_CONVERT_DBG_MASK,"thread=%" PRIx64 " %s retval=%d\n",std::this_thread::get_id(),m_functionName[type],retval);
-    signalWorkload();
-    waitForWork();
-    doWork();
+bool Convert::fastForwarding() {
+    return m_opIndex <= m_ffUntil || ( m_sampler && m_sampler->fastForward() ) || ( m_fidelity && modeled() );
+}
+
+// the sampler's model while it fast forwards an iteration, otherwise the hybrid fidelity one
+AnalyticModel& Convert::model() {
+    if ( m_sampler && m_sampler->fastForward() ) {
+        return m_sampler->model();
+    }
+    return m_fidelity->model();
+}
+
+// true if peer is a rank that hybrid fidelity completes analytically
+bool Convert::analyticPeer( SWM_COMM_ID comm_id, SWM_PEER peer ) {
+    if ( ! m_fidelity ) {
+        return false;
+    }
+    if ( (RankID) peer == AnySrc ) {
+        if ( m_fidelity->analytic( m_comms->members( comm_id ) ) ) {
+            m_output.fatal(CALL_INFO,-1,"a receive from any source can't be matched on a communicator with analytic ranks\n");
+        }
+        return false;
+    }
+    return m_fidelity->analytic( m_comms->world( comm_id, peer ) );
+}
+
+// a detailed rank's receive from an analytic rank, it completes after the send
+bool Convert::linkedRecv( SWM_COMM_ID comm_id, SWM_PEER peer ) {
+    return m_fidelity && ! m_fidelity->analytic( m_rank ) && analyticPeer( comm_id, peer );
+}
+
+void Convert::modelSend( SWM_COMM_ID comm_id, SWM_PEER peer, SWM_TAG tag ) {
+    if ( m_fidelity && m_fidelity->analytic( m_rank ) && ! analyticPeer( comm_id, peer ) ) {
+        m_fidelity->sent( m_rank, m_comms->world( comm_id, peer ), &m_comms->members( comm_id ), tag, now() );
+    }
+}
+
+// when a modeled receive posted at post is done, false if it waits for a send. Messages
+// from a sender are taken in order so one waits while an earlier Irecv from it does.
+bool Convert::modelArrival( SWM_COMM_ID comm_id, SWM_PEER peer, SWM_TAG tag, SWM_BYTES bytes, SimTime_t post, SimTime_t* done ) {
+    SimTime_t start = post;
+    if ( linkedRecv( comm_id, peer ) ) {
+        resolveModeled();
+        int src = m_comms->world( comm_id, peer );
+        const Communicators::Members* comm = &m_comms->members( comm_id );
+        for ( auto& iter : m_modelPosted ) {
+            if ( m_comms->world( iter.second.comm, iter.second.peer ) == src && &m_comms->members( iter.second.comm ) == comm ) {
+                return false;
+            }
+        }
+        SimTime_t sent;
+        if ( ! m_fidelity->arrival( src, m_rank, comm, tag, &sent ) ) {
+            return false;
+        }
+        start = std::max( post, sent );
+    }
+    *done = start + fastForwardTime( Recv, bytes );
+    return true;
+}
+
+// Irecvs from analytic ranks whose sends have arrived are done, in the order they were posted
+void Convert::resolveModeled() {
+    std::set<std::pair<int,const Communicators::Members*> > blocked;
+    for ( auto iter = m_modelPosted.begin(); iter != m_modelPosted.end(); ) {
+        ModelPosted& posted = iter->second;
+        auto key = std::make_pair( m_comms->world( posted.comm, posted.peer ), &m_comms->members( posted.comm ) );
+        SimTime_t sent;
+        if ( ! blocked.count( key ) && m_fidelity->arrival( key.first, m_rank, key.second, posted.tag, &sent ) ) {
+            m_doneReqs[iter->first] = std::max( posted.post, sent ) + fastForwardTime( Recv, posted.bytes );
+            iter = m_modelPosted.erase( iter );
+        } else {
+            blocked.insert( key );
+            ++iter;
+        }
+    }
+}
+
+// the current Recv waits for its analytic sender, it looks again every PollInterval
+void Convert::recvAnalytic() {
+    if ( modelArrival( m_args.recv.comm_id, m_args.recv.peer, m_args.recv.tag, m_args.recv.bytes, m_opStart, &m_readyAt ) ) {
+        returnNow();
+        return;
+    }
+    m_modelThen = [=]() { recvAnalytic(); };
+    schedulePoll();
+}
+
+// true if hybrid fidelity completes the current call by the model, every call of an analytic
+// rank and the calls of a detailed one that involve an analytic rank
+bool Convert::modeled() {
+    if ( m_fidelity->analytic( m_rank ) ) {
+        return true;
+    }
+    switch ( m_type ) {
+      case Send:
+      case Isend:
+        return analyticPeer( m_args.send.comm_id, m_args.send.peer );
+      case Recv:
+      case Irecv:
+        return analyticPeer( m_args.recv.comm_id, m_args.recv.peer );
+      // with one analytic peer the other half is simulated when the call is issued
+      case SendRecv:
+        return analyticPeer( m_args.sendrecv.comm_id, m_args.sendrecv.sendpeer ) &&
+            analyticPeer( m_args.sendrecv.comm_id, m_args.sendrecv.recvpeer );
+      case Allreduce:
+        return m_fidelity->analytic( m_comms->members( m_args.allreduce.comm_id ) );
+      case Barrier:
+        return m_fidelity->analytic( m_comms->members( m_args.barrier.comm_id ) );
+      case Iallreduce:
+      case Ibarrier:
+      case Ialltoall:
+        return m_fidelity->analytic( m_comms->members( m_args.icoll.comm_id ) );
+      case Put:
+      case Get:
+      case FetchAdd:
+        return m_fidelity->analytic( m_args.rma.pe );
+      default:
+        return false;
+    }
+}
+
+// time a fast forwarded call takes, size is the communicator size for collectives,
+// calls replayed for a restart take no time
+SimTime_t Convert::fastForwardTime( SWM_type type, uint64_t bytes, int size ) {
+    if ( m_opIndex <= m_ffUntil ) {
+        return 0;
+    }
+    AnalyticModel& model = this->model();
+    switch ( type ) {
+      case Allreduce:
+        return model.allreduce( bytes, size );
+      case Barrier:
+        return model.barrier( size );
+      case Compute:
+        return bytes;
+      case Ialltoall:
+        return model.alltoall( bytes, size );
+      default:
+        return model.pt2pt( bytes );
+    }
+}
+
+bool Convert::allDoneReqs( int len, uint32_t* req_ids ) {
+    for ( int i = 0; i < len; i++ ) {
+        auto iter = m_doneReqs.find( req_ids[i] );
+        if ( iter == m_doneReqs.end() || iter->second >= CollPending ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// index of the request allDoneReqs accepted that completes first, with pending only among
+// those not done yet, -1 if there is none
+int Convert::firstDone( int len, uint32_t* req_ids, bool pending ) {
+    SimTime_t now = this->now();
+    int first = -1;
+    for ( int i = 0; i < len; i++ ) {
+        SimTime_t done = m_doneReqs.at( req_ids[i] );
+        if ( ( ! pending || done > now ) && ( first < 0 || done < m_doneReqs.at( req_ids[first] ) ) ) {
+            first = i;
+        }
+    }
+    return first;
+}
+
+// complete the current call without simulating its communication, sets m_readyAt if it takes time,
+// returns false for calls that have to be issued, including waits on requests that were issued
+bool Convert::fastForward() {
+    m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"opIndex=%" PRIu64 " %s\n",m_opIndex,m_functionName[m_type]);
+    SimTime_t now = this->now();
+    switch ( m_type ) {
+      case Empty:
+      case Exit:
+      case Init:
+      case Finalize:
+        return false;
+      case Send:
+        modelSend( m_args.send.comm_id, m_args.send.peer, m_args.send.tag );
+        m_readyAt = now + fastForwardTime( Send, m_args.send.bytes );
+        break;
+      case Recv:
+        return modelArrival( m_args.recv.comm_id, m_args.recv.peer, m_args.recv.tag, m_args.recv.bytes, now, &m_readyAt );
+      // a detailed rank's receive from an analytic one is issued to wait for the send
+      case SendRecv:
+        if ( linkedRecv( m_args.sendrecv.comm_id, m_args.sendrecv.recvpeer ) ) {
+            return false;
+        }
+        modelSend( m_args.sendrecv.comm_id, m_args.sendrecv.sendpeer, m_args.sendrecv.sendtag );
+        m_readyAt = now + fastForwardTime( SendRecv, m_args.sendrecv.sendbytes );
+        break;
+      case Allreduce:
+        m_readyAt = now + fastForwardTime( Allreduce, m_args.allreduce.bytes, m_comms->size( m_args.allreduce.comm_id ) );
+        break;
+      case Barrier:
+        m_readyAt = now + fastForwardTime( Barrier, 0, m_comms->size( m_args.barrier.comm_id ) );
+        break;
+      case Compute:
+        m_readyAt = now + fastForwardTime( Compute, m_args.compute.ns );
+        break;
+      case Isend:
+        modelSend( m_args.send.comm_id, m_args.send.peer, m_args.send.tag );
+        *m_args.send.handle = m_reqNum;
+        addDoneReq( m_reqNum++, now + fastForwardTime( Isend, m_args.send.bytes ) );
+        break;
+      case Irecv:
+        {
+            *m_args.recv.handle = m_reqNum;
+            SimTime_t done;
+            if ( modelArrival( m_args.recv.comm_id, m_args.recv.peer, m_args.recv.tag, m_args.recv.bytes, now, &done ) ) {
+                addDoneReq( m_reqNum++, done );
+            } else {
+                ModelPosted posted = { m_args.recv.comm_id, m_args.recv.peer, m_args.recv.tag, m_args.recv.bytes, now };
+                m_modelPosted[m_reqNum] = posted;
+                addDoneReq( m_reqNum++, ShmPending );
+            }
+        }
+        break;
+      case Put:
+      case Get:
+        if ( m_args.rma.handle ) {
+            *m_args.rma.handle = m_reqNum;
+            addDoneReq( m_reqNum++, now + fastForwardTime( m_type, m_args.rma.bytes ) );
+        } else {
+            m_readyAt = now + fastForwardTime( m_type, m_args.rma.bytes );
+        }
+        break;
+      // the value isn't known without simulating the other ranks' atomics
+      case FetchAdd:
+        *m_args.rma.result = 0;
+        m_readyAt = now + fastForwardTime( FetchAdd, sizeof(long) );
+        break;
+      case Fence:
+        break;
+      case Iallreduce:
+        *m_args.icoll.handle = m_reqNum;
+        addDoneReq( m_reqNum++, now + fastForwardTime( Allreduce, m_args.icoll.bytes, m_comms->size( m_args.icoll.comm_id ) ) );
+        break;
+      case Ibarrier:
+        *m_args.icoll.handle = m_reqNum;
+        addDoneReq( m_reqNum++, now + fastForwardTime( Barrier, 0, m_comms->size( m_args.icoll.comm_id ) ) );
+        break;
+      case Ialltoall:
+        *m_args.icoll.handle = m_reqNum;
+        addDoneReq( m_reqNum++, now + fastForwardTime( Ialltoall, m_args.icoll.bytes, m_comms->size( m_args.icoll.comm_id ) ) );
+        break;
+      case Wait:
+        return retireDoneReq( m_args.wait.req_id );
+      case Waitall:
+        if ( ! allDoneReqs( m_args.waitall.len, m_args.waitall.req_ids ) ) {
+            return false;
+        }
+        for ( int i = 0; i < m_args.waitall.len; i++ ) {
+            retireDoneReq( m_args.waitall.req_ids[i] );
+        }
+        break;
+      case Test:
+        if ( ! allDoneReqs( 1, &m_args.test.req_id ) ) {
+            return false;
+        }
+        // a test that fails returns when the request completes, a polling loop would
+        // otherwise be handed its next call at the same time forever
+        *m_args.test.flag = isDoneReq( m_args.test.req_id );
+        if ( *m_args.test.flag ) {
+            retireDoneReq( m_args.test.req_id );
+        } else {
+            m_readyAt = std::max( m_readyAt, m_doneReqs.at( m_args.test.req_id ) );
+        }
+        break;
+      case Testall:
+        if ( ! allDoneReqs( m_args.testall.len, m_args.testall.req_ids ) ) {
+            return false;
+        }
+        *m_args.testall.flag = testallDone( m_args.testall.len, m_args.testall.req_ids );
+        if ( ! *m_args.testall.flag ) {
+            int first = firstDone( m_args.testall.len, m_args.testall.req_ids, true );
+            m_readyAt = std::max( m_readyAt, m_doneReqs.at( m_args.testall.req_ids[first] ) );
+        }
+        break;
+      case Waitany:
+        if ( ! allDoneReqs( m_args.waitany.len, m_args.waitany.req_ids ) ) {
+            return false;
+        }
+        *m_args.waitany.index = firstDone( m_args.waitany.len, m_args.waitany.req_ids, false );
+        if ( *m_args.waitany.index >= 0 ) {
+            retireDoneReq( m_args.waitany.req_ids[ *m_args.waitany.index ] );
+        }
+        break;
+      case Waitsome:
+        if ( ! allDoneReqs( m_args.waitsome.len, m_args.waitsome.req_ids ) ) {
+            return false;
+        }
+        *m_args.waitsome.outcount = 0;
+        for ( int i = 0; i < m_args.waitsome.len; i++ ) {
+            retireDoneReq( m_args.waitsome.req_ids[i] );
+            m_args.waitsome.indices[ (*m_args.waitsome.outcount)++ ] = i;
+        }
+        break;
+      default:
+        return false;
+    }
+    return true;
+}
+
+// called for every call the workload makes, whether it is simulated or fast forwarded
+void Convert::scale() {
+    switch ( m_type ) {
+      case Send:
+      case Isend:
+        m_args.send.bytes = scaleBytes( m_args.send.bytes );
+        m_args.send.pktrspbytes = scaleBytes( m_args.send.pktrspbytes );
+        break;
+      case Recv:
+      case Irecv:
+        m_args.recv.bytes = scaleBytes( m_args.recv.bytes );
+        break;
+      case SendRecv:
+        m_args.sendrecv.sendbytes = scaleBytes( m_args.sendrecv.sendbytes );
+        m_args.sendrecv.pktrspbytes = scaleBytes( m_args.sendrecv.pktrspbytes );
+        break;
+      case Allreduce:
+        m_args.allreduce.bytes = scaleBytes( m_args.allreduce.bytes );
+        m_args.allreduce.rspbytes = scaleBytes( m_args.allreduce.rspbytes );
+        break;
+      case Put:
+      case Get:
+        m_args.rma.bytes = scaleBytes( m_args.rma.bytes );
+        break;
+      case Iallreduce:
+      case Ialltoall:
+        m_args.icoll.bytes = scaleBytes( m_args.icoll.bytes );
+        break;
+      case Compute:
+        m_args.compute.ns *= m_computeScale;
+        break;
+      default:
+        break;
+    }
+}
+
+void Convert::newWork() {
+    if ( ! polls() ) {
+        ++m_opIndex;
+        if ( m_opIndex == m_ffUntil && ! atSyncPoint() ) {
+            m_output.fatal(CALL_INFO,-1,"restart position %" PRIu64 " is %s, not the world Allreduce or Barrier with "
+                    "nothing outstanding that was recorded, the replayed calls differ from the checkpointed run\n",
+                    m_ffUntil,m_functionName[m_type]);
+        }
+    }
+    m_opStart = now();
+    for ( auto& mark : m_marks ) {
+        if ( Mark::Iteration == mark.kind ) {
+            m_sampler->mark( mark.id, m_opStart );
+        } else {
+            m_phases->mark( mark.id, m_opStart );
+        }
+    }
+    m_marks.clear();
+    if ( 1 != m_bytesScale || 1 != m_computeScale ) {
+        scale();
+    }
+    if ( ! m_commMatrix ) {
+        return;
+    }
+    switch ( m_type ) {
+      case Send:
+      case Isend:
+        m_commMatrix->record( m_args.send.peer, m_args.send.comm_id, CommMatrix::Pt2Pt, m_args.send.bytes );
+        break;
+      case SendRecv:
+        m_commMatrix->record( m_args.sendrecv.sendpeer, m_args.sendrecv.comm_id, CommMatrix::Pt2Pt, m_args.sendrecv.sendbytes );
+        break;
+      case Allreduce:
+        m_commMatrix->recordAllreduce( m_args.allreduce.comm_id, m_args.allreduce.bytes );
+        break;
+      case Barrier:
+        m_commMatrix->recordBarrier( m_args.barrier.comm_id );
+        break;
+      case Put:
+        m_commMatrix->record( m_args.rma.pe, 0, CommMatrix::Pt2Pt, m_args.rma.bytes );
+        break;
+      case Iallreduce:
+        m_commMatrix->recordAllreduce( m_args.icoll.comm_id, m_args.icoll.bytes );
+        break;
+      case Ibarrier:
+        m_commMatrix->recordBarrier( m_args.icoll.comm_id );
+        break;
+      case Ialltoall:
+        m_commMatrix->recordAlltoall( m_args.icoll.comm_id, m_args.icoll.bytes );
+        break;
+      default:
+        break;
+    }
 }
 
 void Convert::doWork() {
+    newWork();
+    while ( fastForwarding() && fastForward() ) {
+        if ( m_readyAt > now() ) {
+            if ( m_progress ) {
+                m_progress->set( Progress::Blocked, m_opIndex );
+            }
+            returnNow();
+            return;
+        }
+        opDone();
+        nextWork();
+        newWork();
+    }
+
+    if ( m_resumeAt && m_opIndex > m_ffUntil ) {
+        SimTime_t now = this->now();
+        SimTime_t resumeAt = m_resumeAt;
+        m_resumeAt = 0;
+        if ( resumeAt > now ) {
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"resume at %" PRIu64 " ns opIndex=%" PRIu64 "\n",resumeAt,m_opIndex);
+            m_selfLink->send( resumeAt - now, new SwmEvent(SwmEvent::Type::Resume ) );
+            return;
+        }
+    }
+    issueWork();
+}
+
+void Convert::issueWork() {
 
     m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"thread=%" PRIx64 " got %s\n",std::this_thread::get_id(),m_functionName[m_type]);
+    if ( m_progress ) {
+        m_progress->set( Compute == m_type ? Progress::Computing : Exit == m_type && m_finalStage ? Progress::Finished : Progress::Blocked,
+                m_opIndex );
+    }
+    if ( ! m_collectives.empty() && ! m_collProgressed ) {
+        m_collProgressed = true;
+        progressCollectives( [=]() { issueWork(); } );
+        return;
+    }
+    m_collProgressed = false;
+    dropHints();
+    if ( ! m_modelPosted.empty() ) {
+        resolveModeled();
+    }
+    if ( ! m_collectives.empty() && drainsCollectives() ) {
+        m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"%s waits for %zu collectives\n",m_functionName[m_type],m_collectives.size());
+        m_collWatch.clear();
+        for ( auto& iter : m_collectives ) {
+            m_collWatch.push_back( iter.first );
+        }
+        m_watchAll = true;
+        collWait( NULL, 0, true, NULL );
+        return;
+    }
+    if ( m_agg && flushFirst() ) {
+        flushBatch();
+        return;
+    }
+    if ( m_shmem && quietFirst() ) {
+        quiet();
+        return;
+    }
     switch ( m_type ) {
       case Exit:
 		m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"exit\n");
+        if ( ! m_finalStage ) {
+            m_selfLink->send( new SwmEvent(SwmEvent::Type::StageDone ) );
+            break;
+        }
+        if ( m_sampler ) {
+            m_sampler->exit( now() );
+        }
+        if ( m_phases ) {
+            m_phases->exit( now() );
+        }
         m_selfLink->send( new SwmEvent(SwmEvent::Type::Exit ) );
         break;
       case Init: 
 		m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"init\n");
+        if ( m_initialized ) {
+            returnNow();
+            break;
+        }
+        m_initialized = true;
         m_mp->init( &initFunctor );
         break;
       case Finalize: 
 		m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"finalize\n");
-        m_mp->fini( &finiFunctor );
+        if ( ! m_finalStage ) {
+            returnNow();
+            break;
+        }
+        leave();
         break;
       case Send:
         {
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"send peer=%d comm_id=%d tag=%#x bytes=%d\n",
                     (int)m_args.send.peer,(int)m_args.send.comm_id,(int)m_args.send.tag,(int)m_args.send.bytes);
             Hermes::MemAddr addr(0,NULL);
-            m_mp->send( addr, m_args.send.bytes, CHAR, m_args.send.peer, m_args.send.tag, m_args.send.comm_id, &sendFunctor );
+            expectResponse( m_args.send.peer, m_args.send.comm_id, m_args.send.tag, m_args.send.pktrspbytes );
+            if ( shmPeer( m_args.send.comm_id, m_args.send.peer ) ) {
+                m_readyAt = now() + m_shm->send( m_comms->world( m_args.send.comm_id, m_args.send.peer ), &m_comms->members( m_args.send.comm_id ),
+                        m_args.send.tag, m_args.send.bytes );
+                returnDone();
+                break;
+            }
+            if ( m_agg && m_agg->small( m_args.send.bytes ) ) {
+                aggregate( m_args.send.peer, m_args.send.comm_id, m_args.send.tag, m_args.send.bytes );
+                // the response can't be waited for while its request is held
+                if ( m_args.send.pktrspbytes ) {
+                    m_aggThen = ThenReturn;
+                    flushBatch();
+                } else {
+                    returnDone();
+                }
+                break;
+            }
+            if ( ! m_collectives.empty() ) {
+                m_collSendThen = &sendFunctor;
+                m_mp->isend( addr, m_args.send.bytes, CHAR, m_args.send.peer, m_args.send.tag, hermesComm( m_args.send.comm_id ), &m_collSendReq, &collSendFunctor );
+                break;
+            }
+            m_mp->send( addr, m_args.send.bytes, CHAR, m_args.send.peer, m_args.send.tag, hermesComm( m_args.send.comm_id ), &sendFunctor );
         }
         break;
       case Isend:
         {
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"isend peer=%d comm_id=%d tag=%#x bytes=%d handle=%d\n",
                     (int)m_args.send.peer,(int)m_args.send.comm_id,(int)m_args.send.tag,(int)m_args.send.bytes,*m_args.send.handle);
+            if ( shmPeer( m_args.send.comm_id, m_args.send.peer ) ) {
+                uint32_t num = m_reqNum++;
+                *m_args.send.handle = num;
+                expectResponse( m_args.send.peer, m_args.send.comm_id, m_args.send.tag, m_args.send.pktrspbytes );
+                if ( m_args.send.pktrspbytes ) {
+                    Posted posted = { true, m_args.send.peer, m_args.send.comm_id, (uint32_t) m_args.send.tag, m_args.send.pktrspbytes };
+                    m_posted[num] = posted;
+                }
+                addDoneReq( num, now() + m_shm->send( m_comms->world( m_args.send.comm_id, m_args.send.peer ), &m_comms->members( m_args.send.comm_id ),
+                        m_args.send.tag, m_args.send.bytes ) );
+                returnNow();
+                break;
+            }
+            if ( m_agg && m_agg->small( m_args.send.bytes ) ) {
+                uint32_t num = m_reqNum++;
+                *m_args.send.handle = num;
+                expectResponse( m_args.send.peer, m_args.send.comm_id, m_args.send.tag, m_args.send.pktrspbytes );
+                if ( m_args.send.pktrspbytes ) {
+                    Posted posted = { true, m_args.send.peer, m_args.send.comm_id, (uint32_t) m_args.send.tag, m_args.send.pktrspbytes };
+                    m_posted[num] = posted;
+                }
+                aggregate( m_args.send.peer, m_args.send.comm_id, m_args.send.tag, m_args.send.bytes );
+                addDoneReq( num, now() );
+                returnNow();
+                break;
+            }
             Hermes::MemAddr addr(0,NULL);
             uint32_t num;
             MessageRequest* req;
             std::tie(num,req) = allocMsgReq();
             *m_args.send.handle = num;
             m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"Isend handle=%d req=%p\n",num,req);
-            m_mp->isend( addr, m_args.send.bytes, CHAR, m_args.send.peer, m_args.send.tag, m_args.send.comm_id, req, &isendFunctor );
+            expectResponse( m_args.send.peer, m_args.send.comm_id, m_args.send.tag, m_args.send.pktrspbytes );
+            if ( m_args.send.pktrspbytes ) {
+                Posted posted = { true, m_args.send.peer, m_args.send.comm_id, (uint32_t) m_args.send.tag, m_args.send.pktrspbytes };
+                m_posted[num] = posted;
+            }
+            m_mp->isend( addr, m_args.send.bytes, CHAR, m_args.send.peer, m_args.send.tag, hermesComm( m_args.send.comm_id ), req, &isendFunctor );
         }
         break;
       case Recv:
         {
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"recv peer=%d comm_id=%d tag=%#x bytes=%d \n",m_args.recv.peer,m_args.recv.comm_id,m_args.recv.tag,m_args.recv.bytes);
+            if ( linkedRecv( m_args.recv.comm_id, m_args.recv.peer ) ) {
+                recvAnalytic();
+                break;
+            }
 	        Hermes::MemAddr addr(0,NULL);
             m_resp.resize(1);
-	        m_mp->recv( addr, m_args.recv.bytes, CHAR, m_args.recv.peer, m_args.recv.tag, m_args.recv.comm_id, m_resp.data(), &recvFunctor );
+            if ( shmPeer( m_args.recv.comm_id, m_args.recv.peer ) ) {
+                int tag;
+                if ( m_shm->recv( m_comms->world( m_args.recv.comm_id, m_args.recv.peer ), &m_comms->members( m_args.recv.comm_id ), m_args.recv.tag,
+                        ShmBlocking, &tag ) ) {
+                    m_resp[0].src = m_args.recv.peer;
+                    m_resp[0].tag = tag;
+                    returnDone();
+                } else {
+                    waitShm();
+                }
+                break;
+            }
+            if ( m_agg && m_agg->small( m_args.recv.bytes ) ) {
+                Aggregator::Message msg;
+                if ( m_agg->match( m_args.recv.peer, &m_comms->members( m_args.recv.comm_id ), m_args.recv.tag, &msg ) ) {
+                    m_resp[0].src = msg.src;
+                    m_resp[0].tag = msg.tag;
+                    returnDone();
+                } else {
+                    recvBatch();
+                }
+                break;
+            }
+            if ( ! m_collectives.empty() ) {
+                m_req.resize(1);
+                m_mp->irecv( addr, m_args.recv.bytes, CHAR, m_args.recv.peer, m_args.recv.tag, hermesComm( m_args.recv.comm_id ), &m_req[0], &collRecvFunctor );
+                break;
+            }
+	        m_mp->recv( addr, m_args.recv.bytes, CHAR, m_args.recv.peer, m_args.recv.tag, hermesComm( m_args.recv.comm_id ), m_resp.data(), &recvFunctor );
         }
         break;
       case Irecv:
         {
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"irecv peer=%d comm_id=%d tag=%#x bytes=%d \n",m_args.recv.peer,m_args.recv.comm_id,m_args.recv.tag,m_args.recv.bytes);
+            if ( shmPeer( m_args.recv.comm_id, m_args.recv.peer ) ) {
+                uint32_t num = m_reqNum++;
+                *m_args.recv.handle = num;
+                Posted posted = { false, m_args.recv.peer, m_args.recv.comm_id, (uint32_t) m_args.recv.tag, 0 };
+                m_posted[num] = posted;
+                int tag;
+                if ( m_shm->recv( m_comms->world( m_args.recv.comm_id, m_args.recv.peer ), &m_comms->members( m_args.recv.comm_id ), m_args.recv.tag,
+                        num, &tag ) ) {
+                    setDoneResp( num, m_args.recv.peer, tag );
+                    addDoneReq( num, now() );
+                } else {
+                    addDoneReq( num, ShmPending );
+                }
+                returnNow();
+                break;
+            }
+            if ( m_agg && m_agg->small( m_args.recv.bytes ) ) {
+                uint32_t num = m_reqNum++;
+                *m_args.recv.handle = num;
+                Posted posted = { false, m_args.recv.peer, m_args.recv.comm_id, (uint32_t) m_args.recv.tag, 0 };
+                m_posted[num] = posted;
+                Aggregator::Message msg;
+                if ( m_agg->match( m_args.recv.peer, &m_comms->members( m_args.recv.comm_id ), m_args.recv.tag, &msg ) ) {
+                    setDoneResp( num, msg.src, msg.tag );
+                    addDoneReq( num, now() );
+                } else {
+                    m_agg->post( num, m_args.recv.peer, &m_comms->members( m_args.recv.comm_id ), m_args.recv.tag );
+                    addDoneReq( num, AggPending );
+                }
+                returnNow();
+                break;
+            }
 	        Hermes::MemAddr addr(0,NULL);
             uint32_t num;
             MessageRequest* req;
             std::tie(num,req) = allocMsgReq();
             *m_args.recv.handle = num;
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"Irecv handle=%d %p\n",num,req);
-	        m_mp->irecv( addr, m_args.recv.bytes, CHAR, m_args.recv.peer, m_args.recv.tag, m_args.recv.comm_id, req, &irecvFunctor );
+            Posted posted = { false, m_args.recv.peer, m_args.recv.comm_id, (uint32_t) m_args.recv.tag, 0 };
+            m_posted[num] = posted;
+	        m_mp->irecv( addr, m_args.recv.bytes, CHAR, m_args.recv.peer, m_args.recv.tag, hermesComm( m_args.recv.comm_id ), req, &irecvFunctor );
         }
         break;
       case SendRecv:
@@ -142,49 +1925,321 @@ void Convert::doWork() {
 				m_args.sendrecv.comm_id, m_args.sendrecv.sendpeer, m_args.sendrecv.sendtag, m_args.sendrecv.sendbytes, m_args.sendrecv.recvpeer, m_args.sendrecv.recvtag );
 	        Hermes::MemAddr addr(0,NULL);
 			m_req.resize(1);
-	        m_mp->irecv( addr, m_args.sendrecv.sendbytes, CHAR, m_args.sendrecv.recvpeer, m_args.sendrecv.recvtag, m_args.sendrecv.comm_id, &m_req[0], &sendrecvIrecvFunctor );
+            m_resp.resize(1);
+            m_modelRecv = analyticPeer( m_args.sendrecv.comm_id, m_args.sendrecv.recvpeer );
+            if ( m_modelRecv ) {
+                m_shmRecvLocal = false;
+                m_aggRecv = false;
+                handleSendRecvIrecvReturn( 0, 0 );
+                break;
+            }
+            m_shmRecvLocal = shmPeer( m_args.sendrecv.comm_id, m_args.sendrecv.recvpeer );
+            if ( m_shmRecvLocal ) {
+                int tag;
+                m_shmArrived = m_shm->recv( m_comms->world( m_args.sendrecv.comm_id, m_args.sendrecv.recvpeer ), &m_comms->members( m_args.sendrecv.comm_id ),
+                        m_args.sendrecv.recvtag, ShmBlocking, &tag );
+                if ( m_shmArrived ) {
+                    m_resp[0].tag = tag;
+                }
+                handleSendRecvIrecvReturn( 0, 0 );
+                break;
+            }
+            // a small message is looked for once the send half is done
+            m_aggRecv = m_agg && m_agg->small( m_args.sendrecv.sendbytes );
+            if ( m_aggRecv ) {
+                handleSendRecvIrecvReturn( 0, 0 );
+                break;
+            }
+	        m_mp->irecv( addr, m_args.sendrecv.sendbytes, CHAR, m_args.sendrecv.recvpeer, m_args.sendrecv.recvtag, hermesComm( m_args.sendrecv.comm_id ), &m_req[0], &sendrecvIrecvFunctor );
 		}
 		break;
       case Wait: 
 		{
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"wait\n");
+            if ( collPendingReq( m_args.wait.req_id ) ) {
+                watchCollectives( 1, &m_args.wait.req_id, true );
+                collWait( NULL, 0, true, NULL );
+                break;
+            }
+            bool aggregated = false;
+            if ( pendingReq( m_args.wait.req_id, &aggregated ) ) {
+                waitPending( aggregated );
+                break;
+            }
             m_req.resize( 1 );
             m_resp.resize( 1 );
+            if ( retireDoneReq( m_args.wait.req_id ) ) {
+                completed( m_args.wait.req_id, NULL );
+                returnDone();
+                break;
+            }
             m_req[0] = *findMsgReq( m_args.wait.req_id ); 
             freeMsgReq( m_args.wait.req_id ); 
+            if ( ! m_collectives.empty() ) {
+                collWait( m_req.data(), 1, false, &waitFunctor );
+                break;
+            }
 	        m_mp->wait( m_req[0], &m_resp[0], &waitFunctor);
 		}
 		break;
       case Waitall: 
         {
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"waitall len=%d\n",m_args.waitall.len);
-            m_req.resize( m_args.waitall.len );
-            m_resp.resize( m_args.waitall.len );
+            watchCollectives( m_args.waitall.len, m_args.waitall.req_ids, true );
+            if ( ! m_collWatch.empty() ) {
+                collWait( NULL, 0, true, NULL );
+                break;
+            }
+            bool aggregated = false;
+            if ( anyPendingReq( m_args.waitall.len, m_args.waitall.req_ids, &aggregated ) ) {
+                waitPending( aggregated );
+                break;
+            }
+            m_req.clear();
+            m_waitIds.clear();
+            m_doneIds.clear();
             for ( int i = 0; i < m_args.waitall.len; i++ ) {
-                m_req[i] = *findMsgReq( m_args.waitall.req_ids[i] ); 
-                m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"id=%d req=%p\n",m_args.waitall.req_ids[i],m_req[i]);
+                if ( retireDoneReq( m_args.waitall.req_ids[i] ) ) {
+                    m_doneIds.push_back( m_args.waitall.req_ids[i] );
+                    continue;
+                }
+                m_req.push_back( *findMsgReq( m_args.waitall.req_ids[i] ) ); 
+                m_waitIds.push_back( m_args.waitall.req_ids[i] );
+                m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"id=%d req=%p\n",m_args.waitall.req_ids[i],m_req.back());
                 freeMsgReq( m_args.waitall.req_ids[i] ); 
             }
-	        m_mp->waitall( m_args.waitall.len, m_req.data(), (MessageResponse**) m_resp.data(), &waitallFunctor);
+            if ( m_req.empty() ) {
+                returnDone();
+                break;
+            }
+            m_resp.resize( m_req.size() );
+            m_respPtr.resize( m_req.size() );
+            for ( size_t i = 0; i < m_req.size(); i++ ) {
+                m_respPtr[i] = &m_resp[i];
+            }
+            if ( ! m_collectives.empty() ) {
+                collWait( m_req.data(), m_req.size(), true, &waitallFunctor );
+                break;
+            }
+	        m_mp->waitall( m_req.size(), m_req.data(), m_respPtr.data(), &waitallFunctor);
         }
 		break;
+      case Test:
+        {
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"test id=%d\n",m_args.test.req_id);
+            bool aggregated = false;
+            if ( pendingReq( m_args.test.req_id, &aggregated ) && aggregated && ! m_batchTested ) {
+                testBatch();
+                break;
+            }
+            m_batchTested = false;
+            if ( m_doneReqs.find( m_args.test.req_id ) != m_doneReqs.end() ) {
+                *m_args.test.flag = isDoneReq( m_args.test.req_id );
+                if ( *m_args.test.flag ) {
+                    retireDoneReq( m_args.test.req_id );
+                }
+                returnNow();
+                break;
+            }
+            m_req.resize( 1 );
+            m_resp.resize( 1 );
+            m_req[0] = *findMsgReq( m_args.test.req_id );
+            m_mp->test( m_req[0], &m_flag, &m_resp[0], &testFunctor );
+        }
+        break;
+      case Testall:
+        {
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"testall len=%d\n",m_args.testall.len);
+            bool aggregated = false;
+            if ( anyPendingReq( m_args.testall.len, m_args.testall.req_ids, &aggregated ) && aggregated && ! m_batchTested ) {
+                testBatch();
+                break;
+            }
+            m_batchTested = false;
+            m_reqIds = m_args.testall.req_ids;
+            m_pending.clear();
+            for ( int i = 0; i < m_args.testall.len; i++ ) {
+                if ( m_doneReqs.find( m_reqIds[i] ) == m_doneReqs.end() ) {
+                    m_pending.push_back( i );
+                }
+            }
+            m_pendingPos = 0;
+            if ( m_pending.empty() ) {
+                *m_args.testall.flag = testallDone( m_args.testall.len, m_reqIds );
+                returnNow();
+                break;
+            }
+            testPending( &testallFunctor );
+        }
+        break;
+      case Waitany:
+        {
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"waitany len=%d\n",m_args.waitany.len);
+            m_req.clear();
+            m_pending.clear();
+            *m_args.waitany.index = -1;
+            bool pending = false;
+            bool aggregated = false;
+            bool local = false;
+            for ( int i = 0; i < m_args.waitany.len; i++ ) {
+                if ( pendingReq( m_args.waitany.req_ids[i], &aggregated, &local ) || collPendingReq( m_args.waitany.req_ids[i] ) ) {
+                    pending = true;
+                    continue;
+                }
+                if ( retireDoneReq( m_args.waitany.req_ids[i] ) ) {
+                    *m_args.waitany.index = i;
+                    break;
+                }
+                m_req.push_back( *findMsgReq( m_args.waitany.req_ids[i] ) );
+                m_pending.push_back( i );
+            }
+            if ( *m_args.waitany.index != -1 || ( m_req.empty() && ! pending ) ) {
+                returnNow();
+                break;
+            }
+            if ( aggregated ) {
+                m_req.push_back( m_batchReq );
+            }
+            m_resp.resize( 1 );
+            // a message from the node can complete the call first
+            if ( local ) {
+                waitLocal();
+                break;
+            }
+            if ( ! m_collectives.empty() ) {
+                watchCollectives( m_args.waitany.len, m_args.waitany.req_ids, false );
+                collWait( m_req.data(), m_req.size(), false, &waitanyFunctor );
+                break;
+            }
+            m_mp->waitany( m_req.size(), m_req.data(), &m_index, &m_resp[0], &waitanyFunctor );
+        }
+        break;
+      case Waitsome:
+        {
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"waitsome len=%d\n",m_args.waitsome.len);
+            m_reqIds = m_args.waitsome.req_ids;
+            m_req.clear();
+            m_pending.clear();
+            *m_args.waitsome.outcount = 0;
+            bool pending = false;
+            bool aggregated = false;
+            bool local = false;
+            for ( int i = 0; i < m_args.waitsome.len; i++ ) {
+                if ( pendingReq( m_reqIds[i], &aggregated, &local ) || collPendingReq( m_reqIds[i] ) ) {
+                    pending = true;
+                } else if ( retireDoneReq( m_reqIds[i] ) ) {
+                    m_args.waitsome.indices[ (*m_args.waitsome.outcount)++ ] = i;
+                } else {
+                    m_req.push_back( *findMsgReq( m_reqIds[i] ) );
+                    m_pending.push_back( i );
+                }
+            }
+            if ( *m_args.waitsome.outcount || ( m_req.empty() && ! pending ) ) {
+                returnNow();
+                break;
+            }
+            if ( aggregated ) {
+                m_req.push_back( m_batchReq );
+            }
+            m_resp.resize( 1 );
+            if ( local ) {
+                waitLocal();
+                break;
+            }
+            if ( ! m_collectives.empty() ) {
+                watchCollectives( m_args.waitsome.len, m_reqIds, false );
+                collWait( m_req.data(), m_req.size(), false, &waitsomeAnyFunctor );
+                break;
+            }
+            m_mp->waitany( m_req.size(), m_req.data(), &m_index, &m_resp[0], &waitsomeAnyFunctor );
+        }
+        break;
       case Allreduce: 
 		{
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"allreduce bytes=%d\n",m_args.allreduce.bytes);
 	        Hermes::MemAddr addr(0,NULL);
-			m_mp->allreduce( addr, addr, m_args.allreduce.bytes, CHAR, NOP, m_args.allreduce.comm_id, &allreduceFunctor );
+			m_mp->allreduce( addr, addr, m_args.allreduce.bytes, CHAR, NOP, hermesComm( m_args.allreduce.comm_id ), &allreduceFunctor );
 		}
         break;
       case Barrier: 
 		{
             m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"barrier\n");
 	        Hermes::MemAddr addr(0,NULL);
-			m_mp->barrier( m_args.barrier.comm_id, &barrierFunctor );
+			m_mp->barrier( hermesComm( m_args.barrier.comm_id ), &barrierFunctor );
 		}
         break;
       case Compute: 
-        m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"compute ns=%f\n",m_args.compute.ns);
-        m_selfLink->send( (SimTime_t)m_args.compute.ns, new SwmEvent(SwmEvent::Type::MP_Returned, 0, m_type ) );
+        {
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"compute ns=%f\n",m_args.compute.ns);
+            if ( m_contention ) {
+                m_computing = true;
+                SimTime_t delay = m_contention->start( m_args.compute.ns, now() );
+                m_selfLink->send( delay, new SwmEvent(SwmEvent::Type::ComputeDone, ++m_computeGen ) );
+                break;
+            }
+            m_selfLink->send( m_args.compute.ns, new SwmEvent(SwmEvent::Type::MP_Returned, 0, m_type ) );
+        }
+        break;
+      case CommSplit:
+        m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"split comm_id=%d color=%d key=%d\n",m_args.comm.comm_id,m_args.comm.color,m_args.comm.key);
+        m_comms->deposit( m_args.comm.comm_id, m_args.comm.color, m_args.comm.key );
+        m_mp->barrier( hermesComm( m_args.comm.comm_id ), &commSplitFunctor );
+        break;
+      case CommCreate:
+        m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"create comm_id=%d ndims=%d\n",m_args.comm.comm_id,m_args.comm.ndims);
+        if ( 0 == m_args.comm.ndims ) {
+            createComm( m_comms->members( m_args.comm.comm_id ) );
+        } else {
+            createComm( m_comms->cartSub( m_args.comm.comm_id, m_args.comm.ndims, m_args.comm.dims, m_args.comm.remain ) );
+        }
+        break;
+      case CommFree:
+        m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"free comm_id=%d\n",m_args.comm.comm_id);
+        m_mp->comm_destroy( hermesComm( m_args.comm.comm_id ), &commFreeFunctor );
+        m_comms->free( m_args.comm.comm_id );
+        break;
+      case Put:
+      case Get:
+        {
+            m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"%s pe=%d bytes=%d blocking=%d\n",m_functionName[m_type],
+                    (int)m_args.rma.pe,(int)m_args.rma.bytes,NULL == m_args.rma.handle);
+            checkRma();
+            // only the bytes moved are modeled, every transfer starts at the heap
+            Hermes::Vaddr addr = m_heap.getSimVAddr();
+            bool blocking = NULL == m_args.rma.handle;
+            if ( ! blocking ) {
+                *m_args.rma.handle = m_reqNum;
+                addDoneReq( m_reqNum++, RmaPending );
+            }
+            SWM_type type = m_type;
+            Shmem::Callback callback = [=]( int retval ) { handleReturn( retval, type ); };
+            if ( Put == m_type ) {
+                m_shmem->put( addr, addr, m_args.rma.bytes, m_args.rma.pe, blocking, callback );
+            } else {
+                m_shmem->get( addr, addr, m_args.rma.bytes, m_args.rma.pe, blocking, callback );
+            }
+        }
+        break;
+      case FetchAdd:
+        m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"fetch add pe=%d value=%ld\n",(int)m_args.rma.pe,m_args.rma.value);
+        checkRma();
+        m_operand = m_args.rma.value;
+        m_shmem->fadd( m_fetchedValue, m_atomic.getSimVAddr(), m_operandValue, m_args.rma.pe, [=]( int retval ) {
+            *m_args.rma.result = m_fetched;
+            handleReturn( retval, FetchAdd );
+        } );
+        break;
+      case Iallreduce:
+      case Ibarrier:
+      case Ialltoall:
+        startCollective();
+        break;
+      case Fence:
+        m_output.debug(CALL_INFO, 1, SWM_CONVERT_DBG_MASK,"fence\n");
+        if ( ! m_shmem ) {
+            m_output.fatal(CALL_INFO,-1,"Fence needs one-sided communication, set shmemHeap\n");
+        }
+        m_shmem->fence( [=]( int retval ) { handleReturn( retval, Fence ); } );
         break;
     }
 }
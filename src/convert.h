@@ -17,10 +17,30 @@
 #define _SWM_CONVERT_H
 
 #include <sst/core/output.h>
+#include <sst/core/simulation.h>
+#include <sst/core/timeLord.h>
+#include <functional>
+#include <set>
 #include <sst/elements/hermes/msgapi.h>
+#include <sst/elements/hermes/shmemapi.h>
 #include <swm-include.h>
+#include "swmext.h"
 
+#include "checkpoint.h"
+#include "aggregate.h"
+#include "commmatrix.h"
+#include "communicator.h"
+#include "contention.h"
+#include "fidelity.h"
+#include "histogram.h"
+#include "phases.h"
+#include "progress.h"
+#include "responses.h"
+#include "sampler.h"
+#include "shm.h"
+#include "timeline.h"
 #include "event.h"
+#include "generator.h"
 #include "dbg.h"
 
 #if 1
@@ -53,8 +73,22 @@ namespace Swm {
     NAME(Barrier) \
     NAME(Wait) \
     NAME(Waitall) \
+    NAME(Test) \
+    NAME(Testall) \
+    NAME(Waitany) \
+    NAME(Waitsome) \
     NAME(Finalize) \
-    NAME(Compute)
+    NAME(Compute) \
+    NAME(CommSplit) \
+    NAME(CommCreate) \
+    NAME(CommFree) \
+    NAME(Put) \
+    NAME(Get) \
+    NAME(FetchAdd) \
+    NAME(Fence) \
+    NAME(Iallreduce) \
+    NAME(Ibarrier) \
+    NAME(Ialltoall)
 
 #define GENERATE_ENUM(ENUM) ENUM,
 #define GENERATE_STRING(STRING) #STRING,
@@ -63,11 +97,56 @@ class Convert {
 
     static const char *m_functionName[];
   public:
-	Convert( Link*, MP::Interface* mp, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask);
+    // what the component built for this rank, a NULL pointer turns that feature off
+    struct Features {
+        Features() : shmem(NULL), shmemHeap(0), comms(NULL), checkpoint(NULL), sampler(NULL), commMatrix(NULL),
+            timeline(NULL), progress(NULL), shm(NULL), aggregator(NULL), phases(NULL), contention(NULL),
+            fidelity(NULL), histograms(NULL) {}
+        Shmem::Interface*   shmem;
+        size_t              shmemHeap;
+        Communicators*      comms;
+        Checkpoint*         checkpoint;
+        Sampler*            sampler;
+        CommMatrix*         commMatrix;
+        Timeline*           timeline;
+        Progress*           progress;
+        Shm*                shm;
+        Aggregator*         aggregator;
+        Phases*             phases;
+        Contention*         contention;
+        Fidelity*           fidelity;
+        Histograms*         histograms;
+    };
+
+	Convert( Link*, MP::Interface* mp, int jobId, int rank, const Features& features, uint32_t verboseLevel, uint32_t verboseMask);
+
+    // the workload runs on the SST thread instead of its own
+    void setGenerator( Generator* generator ) { m_generator = generator; }
+
+    // every message size and compute time the workload asks for is multiplied, for sweeps
+    void setScale( double bytes, double compute ) {
+        m_bytesScale = bytes;
+        m_computeScale = compute;
+    }
+
+    // the workload of the next stage of a chain makes the calls from here on, Init is only
+    // issued for the first stage and Finalize and Exit only for the final one
+    void nextStage( bool final ) {
+        std::unique_lock<std::mutex> lck(m_mtx);
+        m_type = Empty;
+        m_finalStage = final;
+    }
+
+    static const char** functionNames() { return m_functionName; }
+    static int numFunctions();
 
     void waitForWork();
+    void nextWork();
     void doWork();
+    void issueWork();
     void MP_returned(int retval, int type );
+    void computeDone( int generation );
+    void poll( int generation );
 
     void init();
 	void exit();
@@ -81,12 +160,31 @@ class Convert {
 	void irecv(SWM_PEER peer, SWM_COMM_ID comm_id, SWM_TAG tag, SWM_BUF buf, SWM_BYTES bytes, uint32_t* handle);
 	void waitall(int len, uint32_t * req_ids);
 	void wait(uint32_t req_ids);
+	void test(uint32_t req_id, int* flag);
+	void testall(int len, uint32_t * req_ids, int* flag);
+	void waitany(int len, uint32_t * req_ids, int* index);
+	void waitsome(int len, uint32_t * req_ids, int* outcount, int* indices);
 	void allreduce( SWM_BYTES bytes, SWM_BYTES rspbytes, SWM_COMM_ID comm_id, SWM_VC sendreqvc, SWM_VC sendrspvc, SWM_BUF sendbuf, SWM_BUF rcvbuf,
         SWM_UNKNOWN auto1, SWM_UNKNOWN2 auto2, SWM_ROUTING_TYPE reqrt, SWM_ROUTING_TYPE rsprt);
 	void barrier( SWM_COMM_ID comm_id, SWM_VC reqvc, SWM_VC rspvc, SWM_BUF buf, SWM_UNKNOWN auto1, SWM_UNKNOWN2 auto2, SWM_ROUTING_TYPE reqrt,
         SWM_ROUTING_TYPE rsprt);
 	void compute(double ns);
 	void finalize();
+	void markIteration(SWM_TAG tag);
+	void mark(int phase);
+	void commSplit(SWM_COMM_ID comm_id, int color, int key, SWM_COMM_ID* newcomm);
+	void commDup(SWM_COMM_ID comm_id, SWM_COMM_ID* newcomm);
+	void cartSub(SWM_COMM_ID comm_id, int ndims, const int* dims, const int* remain_dims, SWM_COMM_ID* newcomm);
+	void commFree(SWM_COMM_ID comm_id);
+	int commRank(SWM_COMM_ID comm_id);
+	int commSize(SWM_COMM_ID comm_id);
+	void put(SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle);
+	void get(SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle);
+	void fetchAdd(SWM_PEER pe, long value, long* result);
+	void fence();
+	void iallreduce(SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle);
+	void ibarrier(SWM_COMM_ID comm_id, uint32_t* handle);
+	void ialltoall(SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle);
 
   private:
 
@@ -164,13 +262,163 @@ class Convert {
         struct {
             uint32_t req_id;
         } wait;
+        struct {
+            uint32_t req_id;
+            int* flag;
+        } test;
+        struct {
+            int len;
+            uint32_t* req_ids;
+            int* flag;
+        } testall;
+        struct {
+            int len;
+            uint32_t* req_ids;
+            int* index;
+        } waitany;
+        struct {
+            int len;
+            uint32_t* req_ids;
+            int* outcount;
+            int* indices;
+        } waitsome;
+        struct {
+            SWM_COMM_ID comm_id;
+            int color;
+            int key;
+            int ndims;
+            const int* dims;
+            const int* remain;
+            SWM_COMM_ID* newcomm;
+        } comm;
+        struct {
+            SWM_PEER pe;
+            SWM_BYTES bytes;
+            uint32_t* handle;
+            long value;
+            long* result;
+        } rma;
+        struct {
+            SWM_BYTES bytes;
+            SWM_COMM_ID comm_id;
+            uint32_t* handle;
+        } icoll;
     } m_args;
 
     typedef ArgStatic_Functor <Convert, int, int, bool> Functor;	
 
     bool handleReturn( int type, int retVal);
+    bool handleInitReturn( int notused, int retVal );
     bool handleSendRecvIrecvReturn( int notused, int retVal );
     bool handleSendRecvSendReturn( int notused, int retVal );
+    bool handleTestReturn( int notused, int retVal );
+    bool handleTestallReturn( int notused, int retVal );
+    bool handleWaitanyReturn( int notused, int retVal );
+    bool handleWaitsomeAnyReturn( int notused, int retVal );
+    bool handleWaitsomeTestReturn( int notused, int retVal );
+    bool handlePollReturn( int notused, int retVal );
+    bool handleResponsePostReturn( int notused, int retVal );
+    bool handleResponseWaitReturn( int notused, int retVal );
+    bool handlePrivateReturn( int notused, int retVal );
+    bool handleResponseDrainReturn( int notused, int retVal );
+    void leave();
+    bool handleCommSplitReturn( int notused, int retVal );
+    bool handleCommCreateReturn( int notused, int retVal );
+    void createComm( const Communicators::Members& );
+    bool shmPeer( SWM_COMM_ID comm_id, SWM_PEER peer );
+    void shmArrived( uint32_t id, int tag );
+    void returnDone();
+    void waitPending( bool aggregated );
+    void waitLocal();
+    void waitShm();
+    void schedulePoll();
+    bool flushFirst();
+    void aggregate( SWM_PEER peer, SWM_COMM_ID comm_id, SWM_TAG tag, SWM_BYTES bytes );
+    void flushBatch();
+    void recvBatch();
+    void testBatch();
+    bool handleFlushReturn( int notused, int retVal );
+    bool handleBatchReturn( int notused, int retVal );
+    bool handleBatchInitReturn( int notused, int retVal );
+    bool handleBatchRepostReturn( int notused, int retVal );
+    bool handleBatchTestReturn( int notused, int retVal );
+    bool handleBatchWaitReturn( int notused, int retVal );
+    bool initShmem();
+    void postBatch( Functor* );
+    bool batchArrived();
+    void checkRma();
+    bool quietFirst();
+    bool rmaPending( int len, uint32_t* req_ids );
+    void quiet();
+    bool drainsCollectives();
+    void startCollective();
+    void postRound( uint32_t num );
+    void roundDone( size_t index );
+    void progressCollectives( std::function<void()> then );
+    void testRounds();
+    void collWait( MessageRequest* reqs, size_t count, bool all, Functor* then );
+    void collWaitNext();
+    void watchCollectives( int len, uint32_t* req_ids, bool all );
+    bool handleCollIsendReturn( int notused, int retVal );
+    bool handleCollIrecvReturn( int notused, int retVal );
+    bool handleCollTestReturn( int notused, int retVal );
+    bool handleCollWaitReturn( int notused, int retVal );
+    bool handleCollSendReturn( int notused, int retVal );
+    bool handleCollRecvReturn( int notused, int retVal );
+    bool collPendingReq( uint32_t num ) {
+        auto iter = m_doneReqs.find(num);
+        return iter != m_doneReqs.end() && iter->second == CollPending;
+    }
+    void setDoneResp( uint32_t num, int src, int tag ) {
+        MessageResponse resp;
+        resp.src = src;
+        resp.tag = tag;
+        m_doneResp[num] = resp;
+    }
+
+    // the Hermes communicator for a comm_id the workload passed
+    Communicator hermesComm( SWM_COMM_ID comm_id ) {
+        return m_comms->hermes( comm_id );
+    }
+    void testPending( Functor* );
+    void returnNow();
+    bool fastForward();
+    bool fastForwarding();
+    SimTime_t fastForwardTime( SWM_type, uint64_t bytes, int size = 1 );
+    AnalyticModel& model();
+    bool modeled();
+    bool analyticPeer( SWM_COMM_ID comm_id, SWM_PEER peer );
+    bool linkedRecv( SWM_COMM_ID comm_id, SWM_PEER peer );
+    void modelSend( SWM_COMM_ID comm_id, SWM_PEER peer, SWM_TAG tag );
+    bool modelArrival( SWM_COMM_ID comm_id, SWM_PEER peer, SWM_TAG tag, SWM_BYTES bytes, SimTime_t post, SimTime_t* done );
+    void resolveModeled();
+    void recvAnalytic();
+    bool atSyncPoint();
+    bool polls();
+    void dropHints();
+    void opDone();
+    void recordTimeline();
+    void recordPhase();
+    void recordHistogram();
+    void expectResponse( int peer, int comm, uint32_t tag, SWM_BYTES bytes );
+    void recvResponse( int peer, int comm, SWM_BYTES bytes );
+    void recvCompleted( int peer, int comm, uint32_t tag, MessageResponse* resp );
+    void completed( uint32_t num, MessageResponse* resp );
+    bool startResponses( int retval, int type );
+    void postResponse();
+    void waitResponses( Functor* );
+    void newWork();
+    void scale();
+    SWM_BYTES scaleBytes( SWM_BYTES bytes ) {
+        return bytes * m_bytesScale + 0.5;
+    }
+    bool allDoneReqs( int len, uint32_t* req_ids );
+    int firstDone( int len, uint32_t* req_ids, bool pending );
+    int testallDone( int len, uint32_t* req_ids );
+
+    SimTime_t now() {
+        return m_tConv->convertFromCoreTime( Simulation::getSimulation()->getCurrentSimCycle() );
+    }
     void signalSST( SWM_type );
     void waitForSST();
     void signalWorkload();
@@ -192,6 +440,48 @@ class Convert {
         m_msgReqMap.erase(num);
     }
 
+    // a request that completed in a Testall that returned false, or one that was fast
+    // forwarded, stays valid for the workload but is not known to Hermes, remember when it
+    // completes so a later call can retire it
+    void addDoneReq( uint32_t num, SimTime_t readyAt ) {
+        m_doneReqs[num] = readyAt;
+    }
+    bool isDoneReq( uint32_t num ) {
+        auto iter = m_doneReqs.find(num);
+        return iter != m_doneReqs.end() && iter->second <= now();
+    }
+    // an Irecv whose message from a rank on the node, or in a batch, hasn't arrived
+    bool pendingReq( uint32_t num, bool* aggregated, bool* local = NULL ) {
+        auto iter = m_doneReqs.find(num);
+        if ( iter == m_doneReqs.end() || iter->second < AggPending ) {
+            return false;
+        }
+        *aggregated = *aggregated || iter->second == AggPending;
+        if ( local ) {
+            *local = *local || iter->second == ShmPending;
+        }
+        return true;
+    }
+    bool anyPendingReq( int len, uint32_t* req_ids, bool* aggregated, bool* local = NULL ) {
+        bool pending = false;
+        for ( int i = 0; i < len; i++ ) {
+            pending = pendingReq( req_ids[i], aggregated, local ) || pending;
+        }
+        return pending;
+    }
+    bool retireDoneReq( uint32_t num ) {
+        auto iter = m_doneReqs.find(num);
+        if ( iter == m_doneReqs.end() || iter->second >= CollPending ) {
+            return false;
+        }
+        m_readyAt = std::max( m_readyAt, iter->second );
+        if ( m_histograms ) {
+            m_histograms->complete( num, iter->second, false );
+        }
+        m_doneReqs.erase( iter );
+        return true;
+    }
+
     std::mutex m_mtx;
     std::condition_variable m_cv;
 	std::vector<MessageResponse> m_resp;
@@ -208,8 +498,33 @@ class Convert {
 	Functor sendrecvSendFunctor;
 	Functor waitFunctor;
 	Functor waitallFunctor;
+	Functor testFunctor;
+	Functor testallFunctor;
+	Functor waitanyFunctor;
+	Functor waitsomeAnyFunctor;
+	Functor waitsomeTestFunctor;
+	Functor pollFunctor;
+	Functor responsePostFunctor;
+	Functor responseWaitFunctor;
+	Functor responseDrainFunctor;
+	Functor privateFunctor;
 	Functor allreduceFunctor;
 	Functor barrierFunctor;
+	Functor commSplitFunctor;
+	Functor commCreateFunctor;
+	Functor commFreeFunctor;
+	Functor flushFunctor;
+	Functor batchFunctor;
+	Functor batchInitFunctor;
+	Functor batchRepostFunctor;
+	Functor batchTestFunctor;
+	Functor batchWaitFunctor;
+	Functor collIsendFunctor;
+	Functor collIrecvFunctor;
+	Functor collTestFunctor;
+	Functor collWaitFunctor;
+	Functor collSendFunctor;
+	Functor collRecvFunctor;
 
     Output  m_output;
     Link* m_selfLink;
@@ -218,7 +533,192 @@ class Convert {
 	int m_jobId;
     double m_clockFreq;
     uint32_t m_reqNum;
+    TimeConverter* m_tConv;
+
+    // position in the stream of calls made by the workload, calls up to m_ffUntil are
+    // completed without simulating them and the next one is issued at m_resumeAt. Test,
+    // Testall and Waitsome are not counted, how many a polling loop makes depends on timing
+    // and the replay completes every request at once.
+    uint64_t    m_opIndex;
+    uint64_t    m_ffUntil;
+    SimTime_t   m_resumeAt;
+    Checkpoint* m_checkpoint;
+    Sampler*    m_sampler;
+    // iteration and phase marks the workload made since its last call
+    struct Mark {
+        enum Kind { Iteration, Phase } kind;
+        int id;
+        Mark( Kind kind, int id ) : kind(kind), id(id) {}
+    };
+    std::vector<Mark> m_marks;
+    CommMatrix* m_commMatrix;
+    Timeline*   m_timeline;
+    Progress*   m_progress;
+    Generator*  m_generator;
+    bool        m_initialized;
+    double      m_bytesScale;
+    double      m_computeScale;
+    bool        m_finalStage;
+    Phases*     m_phases;
+    // a compute started with the node's contention model has to end it
+    Contention* m_contention;
+    bool        m_computing;
+    // a contended compute's end can be moved, only the event of the latest generation ends it
+    int         m_computeGen;
+    // with hybrid fidelity calls to or among analytic ranks are fast forwarded, a SendRecv
+    // with one analytic peer simulates only the other half
+    Fidelity*   m_fidelity;
+    bool        m_modelRecv;
+
+    // Irecvs of a detailed rank from analytic ranks that haven't sent yet, done at ShmPending
+    // until the send shows up, and the step a blocking receive takes at the next poll
+    struct ModelPosted {
+        SWM_COMM_ID comm;
+        SWM_PEER    peer;
+        SWM_TAG     tag;
+        SWM_BYTES   bytes;
+        SimTime_t   post;
+    };
+    std::map<uint32_t,ModelPosted>  m_modelPosted;
+    std::function<void()>           m_modelThen;
+    Histograms* m_histograms;
+    Communicators* m_comms;
+    // the communicator being created
+    Communicators::Members m_newMembers;
+    Communicator m_newComm;
+
+    // a copy of world created at Init, traffic the model adds is matched there so it
+    // can't take the workload's own messages
+    Communicator m_private;
+    SimTime_t   m_opStart;
     std::map<uint32_t, MessageRequest* > m_msgReqMap;
+    std::map<uint32_t, SimTime_t> m_doneReqs;
+    SimTime_t m_readyAt;
+
+    // messages to ranks on the node, a request waiting for one is done at ShmPending,
+    // a call that waits on such a request is issued again when the message arrives.
+    // Waitany and Waitsome with Hermes requests as well test those and are issued again
+    // after PollInterval ns if nothing arrived first, a poll of an older generation is stale.
+    static const SimTime_t ShmPending = (SimTime_t) -1;
+    static const uint32_t ShmBlocking = (uint32_t) -1;
+    static const SimTime_t PollInterval = 100;
+    int     m_pollGen;
+    // source and tag of the Irecvs that completed outside Hermes
+    std::map<uint32_t,MessageResponse> m_doneResp;
+    Shm*    m_shm;
+    bool    m_shmRecvLocal;
+    bool    m_shmArrived;
+    bool    m_shmWaiting;
+    bool    m_shmReissue;
+    std::vector<uint32_t>   m_doneIds;
+
+    // small message aggregation, a request waiting for a message in a batch is done at
+    // AggPending, a call that waits on one receives batches until it arrives. Batches go
+    // to world ranks on m_private, m_batchReq is an Irecv for the next one that is posted
+    // at Init and again after each batch so waits can include it with Hermes requests.
+    // Test and Testall test it once before looking at their own requests.
+    static const SimTime_t AggPending = (SimTime_t) -2;
+    static const uint32_t AggTag = 0x7ffffffd;
+    enum AggThen { ThenIssue, ThenReturn, ThenSendRecv };
+    Aggregator*     m_agg;
+    AggThen         m_aggThen;
+    bool            m_aggRecv;
+    MessageRequest  m_batchReq;
+    MessageResponse m_batchResp;
+    bool            m_batchTested;
+
+    // one-sided calls go to the symmetric heap every rank allocates at Init, atomics to a
+    // backed word next to it. A non-blocking call's request is done at RmaPending, a call
+    // that waits on one first waits for all one-sided calls to complete remotely
+    static const SimTime_t RmaPending = (SimTime_t) -3;
+    Shmem::Interface*   m_shmem;
+    size_t              m_shmemHeap;
+    Hermes::MemAddr     m_heap;
+    Hermes::MemAddr     m_atomic;
+    long                m_operand;
+    long                m_fetched;
+    Hermes::Value       m_operandValue;
+    Hermes::Value       m_fetchedValue;
+
+    // non-blocking collectives run as rounds of an Isend and an Irecv on m_private between
+    // world ranks, so point to point calls go on while they are in flight. Their requests are
+    // done at CollPending. Each call tests the rounds before it is issued, blocking calls wait
+    // on their own requests and the rounds together, calls that can't are issued once the
+    // collectives are done.
+    static const SimTime_t CollPending = (SimTime_t) -4;
+    struct Collective {
+        SWM_type        type;
+        uint64_t        bytes;
+        const Communicators::Members* members;
+        int             me;
+        int             size;
+        int             round;
+        int             outstanding;
+        uint32_t        tag;
+    };
+    int collRounds( const Collective& );
+    uint32_t collTag( const Communicators::Members& );
+    std::map<uint32_t,Collective>   m_collectives;
+    std::map<const Communicators::Members*,uint32_t> m_collSeq;
+    std::vector<MessageRequest>     m_collReq;
+    std::vector<uint32_t>           m_collOwner;
+    MessageRequest                  m_collPostReq;
+    uint32_t                        m_collPosting;
+    int                             m_collIndex;
+    int                             m_collFlag;
+    MessageResponse                 m_collResp;
+    bool                            m_collProgressed;
+    bool                            m_collPolling;
+    std::function<void()>           m_collThen;
+    std::function<void()>           m_progressThen;
+
+    // state of a wait that progresses the collectives, see collWait
+    std::vector<uint32_t>           m_collWatch;
+    bool                            m_watchAll;
+    MessageRequest*                 m_waitReqs;
+    std::vector<size_t>             m_waitLeft;
+    std::vector<MessageRequest>     m_waitSet;
+    bool                            m_waitAll;
+    Functor*                        m_waitThen;
+    MessageRequest                  m_collSendReq;
+    Functor*                        m_collSendThen;
+
+    // response traffic, m_posted holds the Irecvs and the Isends that expect a response
+    // until they complete, the responses they generate are posted on m_private before the
+    // call that completed them returns. Test and Testall leave them outstanding in
+    // m_responseReq, the next call with responses or Finalize waits for all of them.
+    static const uint32_t ResponseTag = 0x7ffffffe;
+    struct Posted {
+        bool        send;
+        int         peer;
+        int         comm;
+        uint32_t    tag;
+        SWM_BYTES   rspBytes;
+    };
+    struct Response {
+        bool        send;
+        int         peer;
+        uint64_t    bytes;
+    };
+    std::map<uint32_t,Posted>       m_posted;
+    std::vector<Response>           m_responses;
+    size_t                          m_responsePos;
+    size_t                          m_responseBase;
+    std::vector<MessageRequest>     m_responseReq;
+    std::vector<MessageResponse>    m_responseResp;
+    std::vector<MessageResponse*>   m_responseRespPtr;
+    int                             m_returnVal;
+    int                             m_returnType;
+    bool                            m_allreduceResponse;
+    std::vector<uint32_t>           m_waitIds;
+    std::vector<MessageResponse*>   m_respPtr;
+
+    // state for the request array calls, m_pending holds indices into the workload's req_ids
+    uint32_t*        m_reqIds;
+    std::vector<int> m_pending;
+    size_t           m_pendingPos;
+    int              m_flag;
+    int              m_index;
 };
 
 inline void Convert::signalWorkload( ) {
@@ -237,8 +737,26 @@ inline void Convert::waitForWork() {
     m_output.debug(CALL_INFO, 2, SWM_CONVERT_DBG_MASK,"thread=%" PRIx64 " return\n",std::this_thread::get_id());
 }
 
-// the rest of the call in this file we be run in the context of the workload thread
+// release the workload and wait for its next call
+inline void Convert::nextWork() {
+    if ( m_generator ) {
+        m_type = Empty;
+        while ( Empty == m_type ) {
+            m_generator->next( *this );
+        }
+        return;
+    }
+    signalWorkload();
+    waitForWork();
+}
+
+// the rest of the call in this file we be run in the context of the workload thread, or on
+// the SST thread from Generator::next()
 inline void Convert::signalSST( SWM_type type ) {
+    if ( m_generator ) {
+        m_type = type;
+        return;
+    }
     ConvertDBG( m_jobId, m_rank, "thread=%" PRIx64 " type=%d\n",std::this_thread::get_id(),type);
     {
         std::unique_lock<std::mutex> lck(m_mtx);
@@ -248,6 +766,9 @@ inline void Convert::signalSST( SWM_type type ) {
 }
 
 inline void Convert::waitForSST() {
+    if ( m_generator ) {
+        return;
+    }
     ConvertDBG( m_jobId, m_rank, "thread=%" PRIx64 " enter\n",std::this_thread::get_id());
     std::unique_lock<std::mutex> lck(m_mtx);
     m_cv.wait(lck, [=]{ return m_type == Empty; } );
@@ -436,6 +957,75 @@ inline void Convert::compute(double ns)
     waitForSST( );
 }
 
+// runs in the workload thread, which can't read the simulated time. The mark is
+// applied by the SST thread when the next call arrives, time doesn't move in between.
+inline void Convert::markIteration( SWM_TAG tag )
+{
+    if ( m_sampler ) {
+        m_marks.push_back( Mark( Mark::Iteration, tag ) );
+    }
+}
+
+inline void Convert::commSplit( SWM_COMM_ID comm_id, int color, int key, SWM_COMM_ID* newcomm )
+{
+    m_args.comm.comm_id = comm_id;
+    m_args.comm.color = color;
+    m_args.comm.key = key;
+    m_args.comm.newcomm = newcomm;
+
+    signalSST( CommSplit );
+    waitForSST( );
+}
+
+inline void Convert::commDup( SWM_COMM_ID comm_id, SWM_COMM_ID* newcomm )
+{
+    m_args.comm.comm_id = comm_id;
+    m_args.comm.ndims = 0;
+    m_args.comm.newcomm = newcomm;
+
+    signalSST( CommCreate );
+    waitForSST( );
+}
+
+inline void Convert::cartSub( SWM_COMM_ID comm_id, int ndims, const int* dims, const int* remain_dims, SWM_COMM_ID* newcomm )
+{
+    m_args.comm.comm_id = comm_id;
+    m_args.comm.ndims = ndims;
+    m_args.comm.dims = dims;
+    m_args.comm.remain = remain_dims;
+    m_args.comm.newcomm = newcomm;
+
+    signalSST( CommCreate );
+    waitForSST( );
+}
+
+inline void Convert::commFree( SWM_COMM_ID comm_id )
+{
+    m_args.comm.comm_id = comm_id;
+
+    signalSST( CommFree );
+    waitForSST( );
+}
+
+// the communicator table only changes while the workload waits, these don't need a round trip
+inline int Convert::commRank( SWM_COMM_ID comm_id )
+{
+    return m_comms->rank( comm_id );
+}
+
+inline int Convert::commSize( SWM_COMM_ID comm_id )
+{
+    return m_comms->size( comm_id );
+}
+
+// queued like markIteration()
+inline void Convert::mark( int phase )
+{
+    if ( m_phases ) {
+        m_marks.push_back( Mark( Mark::Phase, phase ) );
+    }
+}
+
 inline void Convert::wait( uint32_t req_id) 
 {
     m_args.wait.req_id = req_id;
@@ -453,6 +1043,112 @@ inline void Convert::waitall(int len, uint32_t * req_ids)
     waitForSST( );
 }
 
+inline void Convert::test( uint32_t req_id, int* flag )
+{
+    m_args.test.req_id = req_id;
+    m_args.test.flag = flag;
+
+    signalSST( Test );
+    waitForSST( );
+}
+
+inline void Convert::testall(int len, uint32_t * req_ids, int* flag )
+{
+    m_args.testall.len = len;
+    m_args.testall.req_ids = req_ids;
+    m_args.testall.flag = flag;
+
+    signalSST( Testall );
+    waitForSST( );
+}
+
+inline void Convert::put( SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle )
+{
+    m_args.rma.pe = pe;
+    m_args.rma.bytes = bytes;
+    m_args.rma.handle = handle;
+
+    signalSST( Put );
+    waitForSST( );
+}
+
+inline void Convert::get( SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle )
+{
+    m_args.rma.pe = pe;
+    m_args.rma.bytes = bytes;
+    m_args.rma.handle = handle;
+
+    signalSST( Get );
+    waitForSST( );
+}
+
+inline void Convert::fetchAdd( SWM_PEER pe, long value, long* result )
+{
+    m_args.rma.pe = pe;
+    m_args.rma.value = value;
+    m_args.rma.result = result;
+
+    signalSST( FetchAdd );
+    waitForSST( );
+}
+
+inline void Convert::fence()
+{
+    signalSST( Fence );
+    waitForSST( );
+}
+
+inline void Convert::iallreduce( SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle )
+{
+    m_args.icoll.bytes = bytes;
+    m_args.icoll.comm_id = comm_id;
+    m_args.icoll.handle = handle;
+
+    signalSST( Iallreduce );
+    waitForSST( );
+}
+
+inline void Convert::ibarrier( SWM_COMM_ID comm_id, uint32_t* handle )
+{
+    m_args.icoll.bytes = 0;
+    m_args.icoll.comm_id = comm_id;
+    m_args.icoll.handle = handle;
+
+    signalSST( Ibarrier );
+    waitForSST( );
+}
+
+inline void Convert::ialltoall( SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle )
+{
+    m_args.icoll.bytes = bytes;
+    m_args.icoll.comm_id = comm_id;
+    m_args.icoll.handle = handle;
+
+    signalSST( Ialltoall );
+    waitForSST( );
+}
+
+inline void Convert::waitany(int len, uint32_t * req_ids, int* index )
+{
+    m_args.waitany.len = len;
+    m_args.waitany.req_ids = req_ids;
+    m_args.waitany.index = index;
+
+    signalSST( Waitany );
+    waitForSST( );
+}
+
+inline void Convert::waitsome(int len, uint32_t * req_ids, int* outcount, int* indices )
+{
+    m_args.waitsome.len = len;
+    m_args.waitsome.req_ids = req_ids;
+    m_args.waitsome.outcount = outcount;
+    m_args.waitsome.indices = indices;
+
+    signalSST( Waitsome );
+    waitForSST( );
+}
+
 }
 }
 #endif
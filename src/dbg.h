@@ -21,5 +21,18 @@
 #define SWM_CONVERT_THREAD_DBG_MASK  (1<<2)
 #define SWM_WORKLOAD_DBG_BITS  (1<<3)
 #define SWM_WORKLOAD_THREAD_DBG_BITS  (1<<4)
+#define SWM_CHECKPOINT_DBG_MASK  (1<<5)
+#define SWM_SAMPLER_DBG_MASK  (1<<6)
+#define SWM_COMMMATRIX_DBG_MASK  (1<<7)
+#define SWM_TIMELINE_DBG_MASK  (1<<8)
+#define SWM_AFFINITY_DBG_MASK  (1<<9)
+#define SWM_TRACE_DBG_MASK  (1<<10)
+#define SWM_COMMUNICATOR_DBG_MASK  (1<<11)
+#define SWM_SHM_DBG_MASK  (1<<12)
+#define SWM_AGGREGATE_DBG_MASK  (1<<13)
+#define SWM_PHASES_DBG_MASK  (1<<14)
+#define SWM_CONTENTION_DBG_MASK  (1<<15)
+#define SWM_FIDELITY_DBG_MASK  (1<<16)
+#define SWM_HISTOGRAM_DBG_MASK  (1<<17)
 
 #endif
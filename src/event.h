@@ -22,7 +22,7 @@ namespace Swm {
 
 class SwmEvent : public SST::Event {
   public:
-    enum Type { StartWorkload, MP_Returned, Exit } type;
+    enum Type { StartWorkload, MP_Returned, Resume, Heartbeat, StageDone, Exit, ComputeDone, Poll } type;
     SwmEvent( Type type, int arg1 = 0, int arg2 = 0 ) : type(type),arg1(arg1),arg2(arg2) {};
     int arg1;
     int arg2;
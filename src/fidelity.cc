@@ -0,0 +1,109 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#include "sst/core/sst_config.h"
+
+#include <sst/core/simulation.h>
+#include <sst/elements/hermes/msgapi.h>
+
+#include <sstream>
+
+#include "fidelity.h"
+#include "report.h"
+
+using namespace SST;
+using namespace SST::Swm;
+using namespace Hermes::MP;
+
+std::map<Fidelity::Key,std::deque<Fidelity::Sent> > Fidelity::m_sent;
+std::mutex Fidelity::m_mutex;
+
+Fidelity::Fidelity( int jobId, int rank, int numRanks, const std::string& detailed, AnalyticModel model,
+        uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_model(model), m_detailed(numRanks,false)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Fidelity::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    requireOneProcess( m_output, "detailedRanks" );
+
+    std::stringstream list( detailed );
+    std::string range;
+    while ( std::getline( list, range, ',' ) ) {
+        int first, last;
+        int num = sscanf( range.c_str(), "%d-%d", &first, &last );
+        if ( num < 1 ) {
+            m_output.fatal(CALL_INFO,-1,"bad rank range \"%s\" in detailedRanks\n",range.c_str());
+        }
+        if ( 1 == num ) {
+            last = first;
+        }
+        if ( first < 0 || last < first || last >= numRanks ) {
+            m_output.fatal(CALL_INFO,-1,"rank range \"%s\" in detailedRanks is outside the job's %d ranks\n",range.c_str(),numRanks);
+        }
+        for ( int i = first; i <= last; i++ ) {
+            m_detailed[i] = true;
+        }
+    }
+    m_output.debug(CALL_INFO, 1, SWM_FIDELITY_DBG_MASK,"%s\n",m_detailed[rank] ? "detailed" : "analytic");
+}
+
+bool Fidelity::analytic( const Communicators::Members& members )
+{
+    auto iter = m_comms.find( &members );
+    if ( iter != m_comms.end() ) {
+        return iter->second;
+    }
+    bool any = false;
+    for ( auto member : members ) {
+        if ( analytic( member ) ) {
+            any = true;
+            break;
+        }
+    }
+    m_comms[&members] = any;
+    return any;
+}
+
+void Fidelity::sent( int src, int dst, const Communicators::Members* comm, uint32_t tag, SimTime_t time )
+{
+    m_output.debug(CALL_INFO, 2, SWM_FIDELITY_DBG_MASK,"src=%d dst=%d tag=%#x time=%" PRIu64 "\n",src,dst,tag,time);
+    Sent entry = { tag, time };
+    std::lock_guard<std::mutex> lck(m_mutex);
+    m_sent[ Key( m_jobId, src, dst, comm ) ].push_back( entry );
+}
+
+bool Fidelity::arrival( int src, int dst, const Communicators::Members* comm, uint32_t tag, SimTime_t* time )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    auto iter = m_sent.find( Key( m_jobId, src, dst, comm ) );
+    if ( iter == m_sent.end() ) {
+        return false;
+    }
+    std::deque<Sent>& queue = iter->second;
+    for ( auto entry = queue.begin(); entry != queue.end(); ++entry ) {
+        if ( AnyTag == tag || entry->tag == tag ) {
+            *time = entry->time;
+            queue.erase( entry );
+            if ( queue.empty() ) {
+                m_sent.erase( iter );
+            }
+            return true;
+        }
+    }
+    return false;
+}
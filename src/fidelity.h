@@ -0,0 +1,82 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _SWM_FIDELITY_H
+#define _SWM_FIDELITY_H
+
+#include <sst/core/output.h>
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "analytic.h"
+#include "communicator.h"
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Hybrid fidelity, the detailed ranks of a job are simulated through Hermes and the others
+// complete their communication by the analytic model. Every rank of the job is given the
+// same list so both ends of a message agree: a message is simulated only when both ranks
+// are detailed and a collective only when all members of its communicator are. Analytic
+// ranks still go through Hermes to initialize and to create communicators.
+//
+// A detailed rank's receive from an analytic rank completes by the model after the later
+// of its post and the send, analytic ranks leave their send times to detailed ones in a
+// table the job's ranks share, matched in order per pair, communicator and tag.
+class Fidelity {
+  public:
+    // detailed is a list of world rank ranges like "0-63,128-191"
+    Fidelity( int jobId, int rank, int numRanks, const std::string& detailed, AnalyticModel model,
+            uint32_t verboseLevel, uint32_t verboseMask );
+
+    bool analytic( int worldRank )  { return ! m_detailed.at( worldRank ); }
+    // true if any member of a communicator is analytic
+    bool analytic( const Communicators::Members& members );
+    AnalyticModel& model()          { return m_model; }
+
+    // ranks are world ranks, a communicator is its interned member list
+    void sent( int src, int dst, const Communicators::Members* comm, uint32_t tag, SimTime_t time );
+    // false if src hasn't sent yet, a tag of AnyTag takes the first message
+    bool arrival( int src, int dst, const Communicators::Members* comm, uint32_t tag, SimTime_t* time );
+
+  private:
+    struct Sent {
+        uint32_t    tag;
+        SimTime_t   time;
+    };
+    typedef std::tuple<int,int,int,const Communicators::Members*> Key;
+    static std::map<Key,std::deque<Sent> > m_sent;
+    static std::mutex m_mutex;
+
+    int                 m_jobId;
+    Output              m_output;
+    AnalyticModel       m_model;
+    std::vector<bool>   m_detailed;
+
+    // communicator members are interned per job so their address identifies them
+    std::map<const Communicators::Members*,bool> m_comms;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,38 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_GENERATOR_H
+#define _SWM_GENERATOR_H
+
+namespace SST {
+namespace Swm {
+
+class Convert;
+
+// A workload that runs without a thread. Convert calls next() on the SST thread each
+// time the rank is ready for its next call, next() makes at most one call on convert
+// the same way a skeleton calls the SWM API, and is called again if it made none. Out
+// arguments such as request handles are written to memory the generator owns and can
+// be read on the following next(). The last call made must be exit().
+class Generator {
+  public:
+    virtual ~Generator() {}
+    virtual void next( Convert& convert ) = 0;
+};
+
+}
+}
+
+#endif
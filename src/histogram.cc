@@ -0,0 +1,160 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+
+
+#include "histogram.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+JobReport<Histograms::Job> Histograms::m_jobs;
+
+Histograms::Histograms( int jobId, int rank, std::string path, const char** names, int numTypes,
+        uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_rank(rank), m_path(path), m_names(names), m_types(numTypes)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Histograms::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    m_jobs.join( jobId );
+}
+
+void Histograms::record( int type, uint64_t bytes, SimTime_t start, SimTime_t end )
+{
+    SimTime_t time = end - start;
+    m_output.debug(CALL_INFO, 2, SWM_HISTOGRAM_DBG_MASK,"%s bytes=%" PRIu64 " time=%" PRIu64 " ns\n",m_names[type],bytes,time);
+    std::unique_ptr<Bins>& bins = m_types[type];
+    if ( ! bins ) {
+        bins.reset( new Bins );
+    }
+    int size = bucket( bytes, SizeBuckets );
+    ++bins->count;
+    bins->time += time;
+    bins->bytes += bytes;
+    ++bins->latency[size][ bucket( time, TimeBuckets ) ];
+    if ( bytes && time ) {
+        ++bins->bandwidth[size][ bucket( bytes * 1000 / time, RateBuckets ) ];
+    }
+}
+
+void Histograms::Bins::merge( const Bins& other )
+{
+    count += other.count;
+    observed += other.observed;
+    time += other.time;
+    bytes += other.bytes;
+    for ( int size = 0; size < SizeBuckets; size++ ) {
+        for ( int i = 0; i < TimeBuckets; i++ ) {
+            latency[size][i] += other.latency[size][i];
+        }
+        for ( int i = 0; i < RateBuckets; i++ ) {
+            bandwidth[size][i] += other.bandwidth[size][i];
+        }
+    }
+}
+
+// the non zero buckets, sizes and values are the lower bounds of their buckets
+void Histograms::write( FILE* fp, const char* rank, const Types& types )
+{
+    for ( size_t type = 0; type < types.size(); type++ ) {
+        if ( ! types[type] ) {
+            continue;
+        }
+        const Bins& bins = *types[type];
+        for ( int size = 0; size < SizeBuckets; size++ ) {
+            for ( int i = 0; i < TimeBuckets; i++ ) {
+                if ( bins.latency[size][i] ) {
+                    fprintf( fp, "%s,%s,%" PRIu64 ",latency_ns,%" PRIu64 ",%u\n", rank, m_names[type],
+                            lowerBound( size ), lowerBound( i ), bins.latency[size][i] );
+                }
+            }
+            for ( int i = 0; i < RateBuckets; i++ ) {
+                if ( bins.bandwidth[size][i] ) {
+                    fprintf( fp, "%s,%s,%" PRIu64 ",bandwidth_MBps,%" PRIu64 ",%u\n", rank, m_names[type],
+                            lowerBound( size ), lowerBound( i ), bins.bandwidth[size][i] );
+                }
+            }
+        }
+    }
+}
+
+void Histograms::finish()
+{
+    m_jobs.leave( m_jobId, [this]( Job& job ) { fold( job ); }, [this]( Job& job ) { report( job ); } );
+}
+
+void Histograms::fold( Job& job )
+{
+    job.types.resize( m_types.size() );
+    for ( size_t type = 0; type < m_types.size(); type++ ) {
+        if ( ! m_types[type] ) {
+            continue;
+        }
+        if ( ! job.types[type] ) {
+            job.types[type].reset( new Bins );
+        }
+        job.types[type]->merge( *m_types[type] );
+    }
+
+    if ( ! m_path.empty() ) {
+        if ( NULL == job.fp ) {
+            job.fp = openJobFile( m_output, m_path, m_jobId, "w", "histogram" );
+            fprintf( job.fp, "rank,op,min_bytes,metric,min_value,count\n" );
+        }
+        write( job.fp, std::to_string( m_rank ).c_str(), m_types );
+    }
+}
+
+void Histograms::report( Job& job )
+{
+    // latency percentiles are the upper bounds of the buckets they fall in
+    for ( size_t type = 0; type < job.types.size(); type++ ) {
+        if ( ! job.types[type] ) {
+            continue;
+        }
+        const Bins& bins = *job.types[type];
+        uint64_t counts[TimeBuckets] = {};
+        for ( int size = 0; size < SizeBuckets; size++ ) {
+            for ( int i = 0; i < TimeBuckets; i++ ) {
+                counts[i] += bins.latency[size][i];
+            }
+        }
+        int p50 = -1, p99 = -1;
+        uint64_t sum = 0;
+        for ( int i = 0; i < TimeBuckets; i++ ) {
+            sum += counts[i];
+            if ( p50 < 0 && sum * 2 >= bins.count ) {
+                p50 = i;
+            }
+            if ( p99 < 0 && sum * 100 >= bins.count * 99 ) {
+                p99 = i;
+            }
+        }
+        m_output.output("job %d: %s %" PRIu64 " calls, %.0f bytes, latency mean %.0f ns p50 < %" PRIu64 " ns p99 < %" PRIu64 " ns%s\n",
+                m_jobId, m_names[type], bins.count, bins.bytes, bins.time / bins.count,
+                lowerBound( p50 + 1 ), lowerBound( p99 + 1 ),
+                bins.observed ? ( ", " + std::to_string( bins.observed ) + " ended at the wait or test that returned them" ).c_str() : "" );
+    }
+
+    if ( job.fp ) {
+        write( job.fp, "job", job.types );
+        fclose( job.fp );
+    }
+}
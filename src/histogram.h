@@ -0,0 +1,129 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _SWM_HISTOGRAM_H
+#define _SWM_HISTOGRAM_H
+
+#include <sst/core/output.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dbg.h"
+#include "report.h"
+
+namespace SST {
+namespace Swm {
+
+// Log2 bucketed histograms of the simulated latency of communication calls and of the
+// bandwidth they achieved, per call type and message size. A blocking call is timed from
+// its issue to its return, a request from the call that posted it to when it completed.
+// Hermes doesn't report when a request it carried completed, so those end at the wait or
+// test that returned them and include any compute in between, the summary says how many
+// samples of a call type were observed that way. Bucket b holds values in [2^(b-1),2^b),
+// 0 is in bucket 0 and the last bucket holds everything larger. Bandwidth is in MB/s. The
+// counters are fixed size arrays allocated the first time a rank records a call type.
+// When the last of a job's ranks in the process finishes the job's merged histograms are
+// summarized, with a path every rank's and the merged counts are written as CSV.
+class Histograms {
+  public:
+    Histograms( int jobId, int rank, std::string path, const char** names, int numTypes,
+            uint32_t verboseLevel, uint32_t verboseMask );
+
+    void record( int type, uint64_t bytes, SimTime_t start, SimTime_t end );
+
+    // requests are tracked in a fixed ring, one overwritten while still pending is not counted
+    void post( uint32_t num, int type, uint64_t bytes, SimTime_t start ) {
+        Posted& posted = m_posted[ num % MaxPosted ];
+        posted.num = num;
+        posted.type = type;
+        posted.bytes = bytes;
+        posted.start = start;
+        posted.valid = true;
+    }
+    // observed when end is the call that found the request done rather than its completion
+    void complete( uint32_t num, SimTime_t end, bool observed ) {
+        Posted& posted = m_posted[ num % MaxPosted ];
+        if ( posted.valid && posted.num == num ) {
+            posted.valid = false;
+            record( posted.type, posted.bytes, posted.start, end );
+            if ( observed ) {
+                ++m_types[posted.type]->observed;
+            }
+        }
+    }
+
+    void finish();
+
+    static const int SizeBuckets = 24;
+    static const int TimeBuckets = 32;
+    static const int RateBuckets = 20;
+
+  private:
+    struct Bins {
+        Bins() : count(0), observed(0), time(0), bytes(0), latency(), bandwidth() {}
+        void merge( const Bins& other );
+        uint64_t    count;
+        uint64_t    observed;
+        double      time;
+        double      bytes;
+        uint32_t    latency[SizeBuckets][TimeBuckets];
+        uint32_t    bandwidth[SizeBuckets][RateBuckets];
+    };
+    typedef std::vector<std::unique_ptr<Bins> > Types;
+
+    static int bucket( uint64_t value, int num ) {
+        return value ? std::min( 64 - __builtin_clzll( value ), num - 1 ) : 0;
+    }
+    static uint64_t lowerBound( int bucket ) {
+        return bucket ? (uint64_t) 1 << ( bucket - 1 ) : 0;
+    }
+    void write( FILE* fp, const char* rank, const Types& types );
+
+    static const int MaxPosted = 1024;
+    struct Posted {
+        Posted() : num(0), type(0), bytes(0), start(0), valid(false) {}
+        uint32_t    num;
+        int         type;
+        uint64_t    bytes;
+        SimTime_t   start;
+        bool        valid;
+    };
+
+    Output          m_output;
+    int             m_jobId;
+    int             m_rank;
+    std::string     m_path;
+    const char**    m_names;
+    Types           m_types;
+    Posted          m_posted[MaxPosted];
+
+    struct Job {
+        Job() : fp(NULL) {}
+        FILE*   fp;
+        Types   types;
+    };
+    void fold( Job& job );
+    void report( Job& job );
+    static JobReport<Job> m_jobs;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,122 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+
+
+#include "phases.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+JobReport<Phases::Ranks> Phases::m_jobs;
+
+Phases::Phases( int jobId, int rank, std::string path, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_rank(rank), m_path(path), m_marked(false), m_start(0)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Phases::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    m_current = &m_phases[-1];
+    m_current->entries = 1;
+
+    m_jobs.join( jobId );
+}
+
+void Phases::mark( int phase, SimTime_t now )
+{
+    m_output.debug(CALL_INFO, 1, SWM_PHASES_DBG_MASK,"phase=%d\n",phase);
+    m_marked = true;
+    m_current->time += now - m_start;
+    m_start = now;
+    m_current = &m_phases[phase];
+    ++m_current->entries;
+}
+
+void Phases::exit( SimTime_t now )
+{
+    m_current->time += now - m_start;
+    m_start = now;
+}
+
+void Phases::finish()
+{
+    for ( auto& iter : m_phases ) {
+        m_output.debug(CALL_INFO, 1, SWM_PHASES_DBG_MASK,"phase=%d entries=%d time=%" PRIu64 " ns wait=%" PRIu64 " ns bytes=%" PRIu64 "\n",
+                iter.first, iter.second.entries, iter.second.time, iter.second.wait, iter.second.bytes);
+    }
+
+    m_jobs.leave( m_jobId,
+            [this]( Ranks& ranks ) {
+                if ( m_marked ) {
+                    ranks[m_rank] = m_phases;
+                }
+            },
+            [this]( Ranks& ranks ) {
+                if ( ! ranks.empty() ) {
+                    report( ranks );
+                }
+            } );
+}
+
+void Phases::report( const Ranks& ranks )
+{
+    // time and wait are the mean and the maximum over the ranks that entered the phase
+    struct Summary {
+        Summary() : ranks(0), entries(0), time(0), maxTime(0), wait(0), maxWait(0), bytes(0) {}
+        int ranks;
+        int entries;
+        double time;
+        SimTime_t maxTime;
+        double wait;
+        SimTime_t maxWait;
+        uint64_t bytes;
+    };
+    std::map<int,Summary> summary;
+    for ( auto& rank : ranks ) {
+        for ( auto& iter : rank.second ) {
+            const Phase& phase = iter.second;
+            Summary& sum = summary[iter.first];
+            ++sum.ranks;
+            sum.entries = std::max( sum.entries, phase.entries );
+            sum.time += phase.time;
+            sum.maxTime = std::max( sum.maxTime, phase.time );
+            sum.wait += phase.wait;
+            sum.maxWait = std::max( sum.maxWait, phase.wait );
+            sum.bytes += phase.bytes;
+        }
+    }
+    m_output.output("job %d: phase breakdown over %zu ranks\n",m_jobId,ranks.size());
+    for ( auto& iter : summary ) {
+        Summary& sum = iter.second;
+        m_output.output("job %d: phase %d entered %d times, time mean %.0f ns max %" PRIu64 " ns, "
+                "communication wait mean %.0f ns max %" PRIu64 " ns, %" PRIu64 " bytes sent\n",
+                m_jobId, iter.first, sum.entries, sum.time / sum.ranks, sum.maxTime,
+                sum.wait / sum.ranks, sum.maxWait, sum.bytes);
+    }
+
+    FILE* fp = openJobFile( m_output, m_path, m_jobId, "w", "phase" );
+    fprintf( fp, "rank,phase,entries,time_ns,wait_ns,bytes\n" );
+    for ( auto& rank : ranks ) {
+        for ( auto& iter : rank.second ) {
+            const Phase& phase = iter.second;
+            fprintf( fp, "%d,%d,%d,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", rank.first, iter.first, phase.entries,
+                    phase.time, phase.wait, phase.bytes );
+        }
+    }
+    fclose( fp );
+}
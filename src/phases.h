@@ -0,0 +1,75 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _SWM_PHASES_H
+#define _SWM_PHASES_H
+
+#include <sst/core/output.h>
+
+#include <map>
+#include <string>
+
+#include "dbg.h"
+#include "report.h"
+
+namespace SST {
+namespace Swm {
+
+// Per phase breakdown of a rank's run, phases are what a skeleton marks with SWM_Mark().
+// A phase lasts from its mark to the next one, the time before the first mark is phase
+// -1. For every phase the simulated time in it, the bytes sent and the time spent
+// blocked in communication are summed over its entries. When the last of a job's ranks
+// in the process finishes the summary is printed and the per rank numbers are written
+// as CSV to path. Nothing is reported for skeletons that mark no phases.
+class Phases {
+  public:
+    Phases( int jobId, int rank, std::string path, uint32_t verboseLevel, uint32_t verboseMask );
+
+    void mark( int phase, SimTime_t now );
+    void record( SimTime_t wait, uint64_t bytes ) {
+        m_current->wait += wait;
+        m_current->bytes += bytes;
+    }
+    void exit( SimTime_t now );
+    void finish();
+
+  private:
+    struct Phase {
+        Phase() : entries(0), time(0), wait(0), bytes(0) {}
+        int         entries;
+        SimTime_t   time;
+        SimTime_t   wait;
+        uint64_t    bytes;
+    };
+
+    Output          m_output;
+    int             m_jobId;
+    int             m_rank;
+    std::string     m_path;
+    bool            m_marked;
+    SimTime_t       m_start;
+    Phase*          m_current;
+    std::map<int,Phase> m_phases;
+
+    typedef std::map<int,std::map<int,Phase> > Ranks;
+    void report( const Ranks& ranks );
+    static JobReport<Ranks> m_jobs;
+};
+
+}
+}
+
+#endif
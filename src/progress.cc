@@ -0,0 +1,93 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "progress.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::deque<Progress::Rank> Progress::m_ranks;
+bool Progress::m_reporter = false;
+SimTime_t Progress::m_lastSim = 0;
+std::chrono::steady_clock::time_point Progress::m_lastWall = std::chrono::steady_clock::now();
+std::mutex Progress::m_mutex;
+
+Progress::Progress( int jobId, int rank )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    m_ranks.emplace_back( jobId, rank );
+    m_rank = &m_ranks.back();
+}
+
+bool Progress::claimReporter()
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    if ( m_reporter ) {
+        return false;
+    }
+    m_reporter = true;
+    return true;
+}
+
+bool Progress::report( SimTime_t now, double wallInterval, int numSlowest, Output& output )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+
+    // take a snapshot, the ranks keep running on the other SST threads
+    struct Snapshot {
+        uint64_t opIndex;
+        int state;
+        Rank* rank;
+        bool operator<( const Snapshot& other ) const { return opIndex < other.opIndex; }
+    };
+    int count[4] = { 0, 0, 0, 0 };
+    std::vector<Snapshot> running;
+    for ( auto& rank : m_ranks ) {
+        int state = rank.state.load( std::memory_order_relaxed );
+        ++count[state];
+        if ( Finished != state ) {
+            running.push_back( { rank.opIndex.load( std::memory_order_relaxed ), state, &rank } );
+        }
+    }
+    if ( running.empty() ) {
+        return false;
+    }
+
+    auto wall = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>( wall - m_lastWall ).count();
+    if ( seconds < wallInterval ) {
+        return true;
+    }
+
+    output.output("progress: %" PRIu64 " ns simulated, %.0f simulated ns per second, ranks %d computing %d blocked %d finished %d not started\n",
+            now, seconds > 0 ? ( now - m_lastSim ) / seconds : 0, count[Computing], count[Blocked], count[Finished], count[Idle] );
+
+    numSlowest = std::min( (size_t) numSlowest, running.size() );
+    std::partial_sort( running.begin(), running.begin() + numSlowest, running.end() );
+    for ( int i = 0; i < numSlowest; i++ ) {
+        static const char* name[] = { "not started", "computing", "blocked", "finished" };
+        output.output("progress:   job %d rank %d at op %" PRIu64 " %s\n", running[i].rank->jobId, running[i].rank->rank,
+                running[i].opIndex, name[ running[i].state ] );
+    }
+
+    m_lastSim = now;
+    m_lastWall = wall;
+    return true;
+}
@@ -0,0 +1,78 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_PROGRESS_H
+#define _SWM_PROGRESS_H
+
+#include <sst/core/output.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Live progress of the ranks simulated in this process. Each rank publishes its state
+// and position in its call stream with relaxed atomic stores, the one component that
+// claims the reporter role reads them all when its heartbeat fires and prints the
+// simulated time rate, how many ranks are computing, blocked or finished and the ranks
+// that are furthest behind.
+class Progress {
+  public:
+    enum State { Idle = 0, Computing = 1, Blocked = 2, Finished = 3 };
+
+    Progress( int jobId, int rank );
+
+    void set( State state ) {
+        m_rank->state.store( state, std::memory_order_relaxed );
+    }
+    void set( State state, uint64_t opIndex ) {
+        m_rank->opIndex.store( opIndex, std::memory_order_relaxed );
+        m_rank->state.store( state, std::memory_order_relaxed );
+    }
+
+    // true for the first caller in the process
+    static bool claimReporter();
+
+    // prints a report if wallInterval seconds have passed since the last one, returns
+    // false once every rank has finished
+    static bool report( SimTime_t now, double wallInterval, int numSlowest, Output& output );
+
+  private:
+    struct Rank {
+        Rank( int jobId, int rank ) : jobId(jobId), rank(rank), state(Idle), opIndex(0) {}
+        int jobId;
+        int rank;
+        std::atomic<int> state;
+        std::atomic<uint64_t> opIndex;
+    };
+
+    Rank* m_rank;
+
+    static std::deque<Rank> m_ranks;
+    static bool m_reporter;
+    static SimTime_t m_lastSim;
+    static std::chrono::steady_clock::time_point m_lastWall;
+    static std::mutex m_mutex;
+};
+
+}
+}
+
+#endif
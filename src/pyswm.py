@@ -16,15 +16,209 @@
 # distribution.
 
 import sst
+import heapq
 from sst.merlin.base import *
 from sst.firefly import *
 
+def readCommMatrixFile(path, collectives=True):
+    """Read a communication matrix written by the Swm component (commMatrixPath). Returns
+    (jobId, numRanks, comms, entries) with comms a list of the world ranks in each communicator,
+    the world communicator first, and entries a list of (src, dst, comm, kind, count, bytes).
+    comm indexes comms, kind is 0 for point to point and 1 for collective traffic. dst is a
+    world rank whatever communicator the traffic was sent on."""
+    import struct
+    with open(path,"rb") as f:
+        data = f.read()
+    if data[0:8] != b"SWMCOMM1":
+        raise RuntimeError("%s is not a communication matrix file"%path)
+    job_id, num_ranks, nnz = struct.unpack_from("<iiQ",data,8)
+    offset = 24
+    row_ptr = struct.unpack_from("<%dQ"%(num_ranks+1),data,offset)
+    offset += 8 * (num_ranks+1)
+    peers = struct.unpack_from("<%di"%nnz,data,offset)
+    offset += 4 * nnz
+    comm_index = struct.unpack_from("<%di"%nnz,data,offset)
+    offset += 4 * nnz
+    kinds = struct.unpack_from("<%dB"%nnz,data,offset)
+    offset += nnz
+    counts = struct.unpack_from("<%dQ"%nnz,data,offset)
+    offset += 8 * nnz
+    nbytes = struct.unpack_from("<%dQ"%nnz,data,offset)
+    offset += 8 * nnz
+    num_comms, = struct.unpack_from("<i",data,offset)
+    offset += 4
+    comms = []
+    for i in range(num_comms):
+        size, = struct.unpack_from("<i",data,offset)
+        offset += 4
+        comms.append( list(struct.unpack_from("<%di"%size,data,offset)) )
+        offset += 4 * size
+
+    entries = []
+    for src in range(num_ranks):
+        for i in range(row_ptr[src],row_ptr[src+1]):
+            if collectives or kinds[i] == 0:
+                entries.append( (src,peers[i],comm_index[i],kinds[i],counts[i],nbytes[i]) )
+    return job_id, num_ranks, comms, entries
+
+def readCommMatrix(path):
+    """Read a communication matrix, either one or more files written by the Swm component
+    (separated by commas, one per SST process) or a text file with one "src dst bytes"
+    triple per line where '#' starts a comment. Returns a dict keyed by (src,dst) with
+    the traffic in both directions summed."""
+    matrix = {}
+    with open(path.split(",")[0],"rb") as f:
+        binary = f.read(8) == b"SWMCOMM1"
+    if binary:
+        for name in path.split(","):
+            job_id, num_ranks, comms, entries = readCommMatrixFile(name)
+            for src, dst, comm, kind, count, nbytes in entries:
+                if src == dst:
+                    continue
+                key = (min(src,dst), max(src,dst))
+                matrix[key] = matrix.get(key,0) + nbytes
+        return matrix
+
+    with open(path) as f:
+        for line in f:
+            line = line.split('#')[0].split()
+            if not line:
+                continue
+            src, dst, nbytes = int(line[0]), int(line[1]), float(line[2])
+            if src == dst:
+                continue
+            key = (min(src,dst), max(src,dst))
+            matrix[key] = matrix.get(key,0) + nbytes
+    return matrix
+
+def readRankMap(path):
+    """Read a rank to node mapping, one "rank node" pair per line, '#' starts a comment"""
+    rank_map = {}
+    with open(path) as f:
+        for line in f:
+            line = line.split('#')[0].split()
+            if line:
+                rank_map[int(line[0])] = int(line[1])
+    return rank_map
+
+def greedyTrafficOrder(num_ranks, matrix):
+    """A greedy linear ordering of ranks by traffic, not a topology aware partitioning.
+    Starting from the rank with the most traffic, repeatedly take the rank with the
+    most traffic to the ranks already taken, so ranks that exchange a lot of data end up
+    close together in the order. Laying the order onto the nodes of an allocation keeps
+    them close in the topology only as far as nearby node ids share routers and groups."""
+    neighbors = [ {} for x in range(num_ranks) ]
+    total = [ 0 ] * num_ranks
+    for (a,b), nbytes in matrix.items():
+        if a >= num_ranks or b >= num_ranks:
+            continue
+        neighbors[a][b] = neighbors[a].get(b,0) + nbytes
+        neighbors[b][a] = neighbors[b].get(a,0) + nbytes
+        total[a] += nbytes
+        total[b] += nbytes
+
+    by_total = sorted(range(num_ranks), key=lambda r: (-total[r], r))
+    next_start = 0
+    placed = [ False ] * num_ranks
+    gain = [ 0 ] * num_ranks
+    heap = []
+    order = []
+    while len(order) < num_ranks:
+        rank = None
+        while heap:
+            g, r = heapq.heappop(heap)
+            if not placed[r] and -g == gain[r]:
+                rank = r
+                break
+        if rank is None:
+            while placed[by_total[next_start]]:
+                next_start += 1
+            rank = by_total[next_start]
+
+        placed[rank] = True
+        order.append(rank)
+        for peer, nbytes in neighbors[rank].items():
+            if not placed[peer]:
+                gain[peer] += nbytes
+                heapq.heappush(heap, (-gain[peer], peer))
+    return order
+
+def nodeTraffic(num_nodes, num_cores, matrix):
+    """Fold a rank matrix onto the job's logical nodes, rank r runs on node r // num_cores.
+    Returns the bytes each node sends and receives and the node matrix without traffic
+    that stays on a node."""
+    total = [ 0 ] * num_nodes
+    nodes = {}
+    for (a,b), nbytes in matrix.items():
+        a, b = a // num_cores, b // num_cores
+        if a >= num_nodes or b >= num_nodes or a == b:
+            continue
+        total[a] += nbytes
+        total[b] += nbytes
+        key = (min(a,b), max(a,b))
+        nodes[key] = nodes.get(key,0) + nbytes
+    return total, nodes
+
+def partitionWeights(total):
+    """Cost of each node when the nodes are cut into partitions, 1 plus its traffic relative
+    to the mean so nodes that exchange a lot of data cost more than the computes every node has"""
+    mean = float(sum(total)) / len(total) if total else 0
+    return [ 1.0 + ( nbytes / mean if mean else 0 ) for nbytes in total ]
+
+def partitionNodes(order, weights, num_parts):
+    """Cut a traffic order of nodes into num_parts contiguous blocks of about equal weight,
+    nodes next to each other in the order exchange a lot of data. Returns the part of each node."""
+    part = [ 0 ] * len(order)
+    target = sum(weights) / max(num_parts,1)
+    current = 0
+    filled = 0
+    for node in order:
+        if filled >= target * ( current + 1 ) and current < num_parts - 1:
+            current += 1
+        part[node] = current
+        filled += weights[node]
+    return part
+
+def rankRanges(ranks):
+    """A list of ranks as the ranges detailedRanks takes, like "0-63,128-191" """
+    ranges = []
+    for rank in sorted(set(ranks)):
+        if ranges and ranges[-1][1] == rank - 1:
+            ranges[-1][1] = rank
+        else:
+            ranges.append([rank,rank])
+    return ",".join( "%d"%a if a == b else "%d-%d"%(a,b) for a, b in ranges )
+
+def weightedNodeDistance(rank_map, matrix):
+    """Mean distance between node ids weighted by bytes, a topology agnostic locality measure"""
+    total = 0
+    weighted = 0
+    for (a,b), nbytes in matrix.items():
+        if a in rank_map and b in rank_map:
+            total += nbytes
+            weighted += nbytes * abs(rank_map[a] - rank_map[b])
+    if not total:
+        return 0
+    return weighted / total
+
 class SwmJob(Job):
+    """A job of Swm workloads, one per rank. Response traffic, communicator splits,
+    aggregation (workload.aggregateBytes) and hybrid fidelity (detailed_nodes or
+    workload.detailedRanks) share state between the job's ranks through tables in the
+    SST process, so they need the simulation to run in one process."""
     def __init__(self,job_id,num_nodes):
         Job.__init__(self,job_id,num_nodes)
         self._declareParams("main",["_os","_numCores","_nicsPerNode","nic"])
+        self._declareParams("mapping",["mapping_file","comm_matrix","mapping_report"])
 
-        self._declareParamsWithUserPrefix("workload","workload",["verboseLevel","verboseMask","numRanks","path","name"])
+        self._declareParamsWithUserPrefix("workload","workload",["verboseLevel","verboseMask","numRanks","path","name",
+                "checkpointPath","checkpointInterval","restartPath",
+                "samplePeriod","sampleWarmup","sampleModel","sampleLatency","sampleBandwidth",
+                "commMatrixPath","startTime","timelinePath","timelineFormat","timelineBuffer",
+                "progressInterval","progressWallInterval","progressSlowest","workloadAffinity","nativeWorkload",
+                "aggregateBytes","aggregateLimit","aggregateWindow","phasePath","shmemHeap","chain","chainPaths","bytesScale","computeScale",
+                "computeMemoryFraction","computeSaturation","detailedRanks","analyticLatency","analyticBandwidth",
+                "histogramPath"])
 
         self._nicsPerNode = 1
         self._numCores = 1
@@ -36,24 +230,143 @@ class SwmJob(Job):
         self.nic = BasicNicConfiguration()
         self._lockVariable("nic")
 
+        # rank placement, by default ranks follow the node allocation
+        self.mapping_file = None
+        self.comm_matrix = None
+        self.mapping_report = None
+        self._mapping_applied = False
+
+        # a recorded or predicted communication matrix in one of the formats comm_matrix
+        # takes, the job's nodes are cut into one partition per SST thread by traffic and
+        # each node's components are placed with setRank, so the run needs the sst.self
+        # partitioner and the caller places the components of the rest of the machine.
+        # partition_report gets the assignment.
+        self.partition_matrix = None
+        self.partition_report = None
+        self._partition = None
+
+        # latency of the links between ranks on the same node, when set their messages
+        # are copies at shm_bandwidth instead of going through the NIC and loopBack
+        self.shm_latency = None
+        self.shm_bandwidth = "10GB/s"
+
+        # values that replace the ones under jobs.cfg in the workload's file, so a sweep
+        # doesn't need a file per point, e.g. { "message_size" : 4096 }
+        self.cfg = {}
+
+        # hybrid fidelity, the ranks on detailed_nodes are simulated in detail and the others
+        # complete their communication by the analytic model of analyticLatency and
+        # analyticBandwidth, workload.detailedRanks picks the ranks by rank range instead.
+        # A detailed rank's receive from an analytic one completes after the send. Receives
+        # from any source can't be matched with analytic senders, a workload that posts one
+        # on a communicator with analytic ranks stops with an error.
+        self.detailed_nodes = None
+
     def getName(self):
         return "SwmJob"
 
+    def _applyRankMapping(self):
+        """Replace the allocation's node to rank map with one from mapping_file, or one that
+        lays a greedy traffic ordering of the ranks in comm_matrix onto the job's nodes.
+        Ranks are placed a node at a time, so with _numCores > 1 the ranks in mapping_file
+        are logical nodes, rank // _numCores, and comm_matrix is folded onto them."""
+        self._mapping_applied = True
+        if not self.mapping_file and not self.comm_matrix:
+            return
+
+        nodes = sorted(self._nid_map.keys())
+        default_map = dict( (rank, node) for node, rank in self._nid_map.items() )
+
+        matrix = None
+        if self.comm_matrix:
+            matrix = nodeTraffic(len(nodes), self._numCores, readCommMatrix(self.comm_matrix))[1]
+        if self.mapping_file:
+            source = self.mapping_file
+            rank_map = readRankMap(self.mapping_file)
+            if sorted(rank_map.keys()) != list(range(len(nodes))) or sorted(rank_map.values()) != nodes:
+                raise RuntimeError("SwmJob %d: %s does not map ranks 0-%d onto the job's nodes"%(self.job_id,self.mapping_file,len(nodes)-1))
+        else:
+            source = self.comm_matrix
+            order = greedyTrafficOrder(len(nodes), matrix)
+            rank_map = dict( (rank, nodes[i]) for i, rank in enumerate(order) )
+
+        self._nid_map = dict( (node, rank) for rank, node in rank_map.items() )
+
+        report = "SwmJob %d: rank mapping from %s"%(self.job_id,source)
+        if matrix is not None:
+            report += ", traffic weighted node distance %.2f (allocation order %.2f)"%(
+                    weightedNodeDistance(rank_map,matrix), weightedNodeDistance(default_map,matrix))
+        print(report)
+
+        if self.mapping_report:
+            with open(self.mapping_report,"w") as f:
+                f.write("# %s\n# %s node\n"%(report,"rank" if self._numCores == 1 else "rank//%d"%self._numCores))
+                for rank in sorted(rank_map.keys()):
+                    f.write("%d %d\n"%(rank,rank_map[rank]))
+
+    def _applyPartitions(self):
+        """Cut the job's nodes into partitions of about equal traffic weighted cost from
+        partition_matrix, keeping nodes that exchange a lot of data together, and write
+        the assignment to partition_report"""
+        num_nodes = len(self._nid_map)
+        total, nodes = nodeTraffic(num_nodes, self._numCores, readCommMatrix(self.partition_matrix))
+        weights = partitionWeights(total)
+        num_parts = sst.getMPIRankCount() * sst.getThreadCount()
+        self._partition = partitionNodes(greedyTrafficOrder(num_nodes, nodes), weights, num_parts)
+
+        if self.partition_report:
+            part = self._partition
+            cut = sum( nbytes for (a,b), nbytes in nodes.items() if part[a] != part[b] )
+            with open(self.partition_report,"w") as f:
+                f.write("# SwmJob %d: %d partitions from %s, %d of %d bytes cross partitions\n"%(
+                        self.job_id,num_parts,self.partition_matrix,cut,sum(nodes.values())))
+                f.write("# node partition weight\n")
+                for nid, lid in sorted(self._nid_map.items()):
+                    f.write("%d %d %.3f\n"%(nid,part[lid],weights[lid]))
+
+    def _detailedRanks(self):
+        """The ranks on detailed_nodes, rank r runs on logical node r // numCores"""
+        num_ranks = getattr(self.workload,"numRanks",None)
+        ranks = []
+        for nid in self.detailed_nodes:
+            if nid not in self._nid_map:
+                raise RuntimeError("SwmJob %d: detailed node %d is not one of the job's nodes"%(self.job_id,nid))
+            lid = self._nid_map[nid]
+            ranks += [ rank for rank in range(lid * self._numCores, (lid + 1) * self._numCores)
+                    if num_ranks is None or rank < int(num_ranks) ]
+        return rankRanges(ranks)
+
     def build(self, nodeID, extraKeys):
 
+        # the mapping has to be in place before anything is built from _nid_map
+        if not self._mapping_applied:
+            self._applyRankMapping()
+        if self.partition_matrix and self._partition is None:
+            self._applyPartitions()
+
         if self._check_first_build():
+            if sst.getMPIRankCount() > 1:
+                for name, value in (("workload.aggregateBytes",getattr(self.workload,"aggregateBytes",None)),
+                        ("workload.detailedRanks",getattr(self.workload,"detailedRanks",None)),
+                        ("detailed_nodes",self.detailed_nodes)):
+                    if value:
+                        raise RuntimeError("SwmJob %d: %s needs SST to run in one process"%(self.job_id,name))
+
             sst.addGlobalParams("lookback_params_%s"%self._instance_name,
                             { "numCores" : self._numCores,
                               "nicsPerNode" : self._nicsPerNode })
 
             sst.addGlobalParam("params_%s"%self._instance_name, 'jobId', self.job_id)
             sst.addGlobalParams("params_%s"%self._instance_name, self._getGroupParams("workload"))
+            for key, value in self.cfg.items():
+                sst.addGlobalParam("params_%s"%self._instance_name, "cfg.%s"%key, value)
+            if self.detailed_nodes is not None:
+                sst.addGlobalParam("params_%s"%self._instance_name, "detailedRanks", self._detailedRanks())
 
         logical_id = self._nid_map[nodeID]
-        core = 0
         nodeNicNum = 0
 
-        nic, slot_name = self.nic.build(nodeID)	
+        nic, slot_name = self.nic.build(nodeID,self._numCores // self._nicsPerNode)
 
         networkif, port_name = self.network_interface.build(nic,slot_name,0,self.job_id,self.size,logical_id,False)
 
@@ -61,22 +374,108 @@ class SwmJob(Job):
         retval = ( networkif, port_name )
 
         loopBack = sst.Component("loopBack" + str(nodeID), "firefly.loopBack")
-  
-        # per core starts here, we currntly only support 1 core
-        ep = sst.Component("nic" + str(nodeID) + "core" + str(core) + "_SWM", "sstSwm.Swm")
-        self._applyStatisticsSettings(ep)
-        ep.addGlobalParamSet("params_%s"%self._instance_name )
+        loopBack.addGlobalParamSet("lookback_params_%s"%self._instance_name)
+
+        eps = []
+        for core in range(self._numCores):
+            ep = sst.Component("nic" + str(nodeID) + "core" + str(core) + "_SWM", "sstSwm.Swm")
+            self._applyStatisticsSettings(ep)
+            ep.addGlobalParamSet("params_%s"%self._instance_name )
+
+            # Create the links to the OS layer
+            nicLink = sst.Link( "nic" + str(nodeID) + "core" + str(core) + "_Link"  )
+            nicLink.setNoCut()
+            nic.addLink(nicLink,'core'+ str(core),'1ns')
+
+            loopLink = sst.Link( "loop" + str(nodeID) + "nic" + str(nodeNicNum) + "core" + str(core) + "_Link"  );
+            loopLink.setNoCut()
+            loopBack.addLink(loopLink,'nic'+str(nodeNicNum)+'core'+str(core),'1ns')
+
+            # Create the OS layer
+            self._os.build(ep,nicLink,loopLink,self.size,self._nicsPerNode,self.job_id,nodeID,logical_id,core)
+            eps.append(ep)
 
-        # Create the links to the OS layer
-        nicLink = sst.Link( "nic" + str(nodeID) + "core" + str(core) + "_Link"  )
-        nicLink.setNoCut()
-        nic.addLink(nicLink,'core'+ str(core),'1ns')
+        if self._partition:
+            part = self._partition[logical_id]
+            for comp in [ nic, loopBack ] + eps:
+                comp.setRank(part // sst.getThreadCount(), part % sst.getThreadCount())
 
-        loopLink = sst.Link( "loop" + str(nodeID) + "nic" + str(nodeNicNum) + "core" + str(core) + "_Link"  );
-        loopLink.setNoCut()
-        loopBack.addLink(loopLink,'nic'+str(nodeNicNum)+'core'+str(core),'1ns')
+        # where each rank is, for the shared memory path and the compute contention model
+        for core, ep in enumerate(eps):
+            ep.addParams({ "numCores" : self._numCores, "nodeId" : nodeID, "coreId" : core })
 
-        # Create the OS layer
-        self._os.build(ep,nicLink,loopLink,self.size,self._nicsPerNode,self.job_id,nodeID,logical_id,core)
+        # a link for each pair of ranks on the node
+        if self.shm_latency and self._numCores > 1:
+            for core, ep in enumerate(eps):
+                ep.addParams({ "shmBandwidth" : self.shm_bandwidth })
+                for other in range(core + 1, self._numCores):
+                    shmLink = sst.Link( "shm" + str(nodeID) + "core" + str(core) + "core" + str(other) + "_Link" )
+                    shmLink.setNoCut()
+                    ep.addLink(shmLink,'shm'+str(other),self.shm_latency)
+                    eps[other].addLink(shmLink,'shm'+str(core),self.shm_latency)
 
         return retval 
+
+class SwmSchedule:
+    """A set of jobs that share the machine, each arriving at its own time.
+
+    A schedule is a list of jobs given with addJob() or read from a JSON file:
+
+        { "jobs" : [
+            { "id" : 0, "name" : "milc", "path" : "milc/milc625.json", "nodes" : 625 },
+            { "id" : 1, "name" : "incast", "path" : "incast/incast100.json", "nodes" : [0,8,16,24],
+              "numRanks" : 4, "start" : "50us" } ] }
+
+    "nodes" is either a count, allocated with "allocation" (linear by default), or a list
+    of node ids. "cores" is the number of ranks per node, 1 by default, "numRanks" defaults
+    to nodes times cores and "start" to 0ns. Nodes no job uses get an EmptyJob so the
+    network is fully populated."""
+
+    def __init__(self, network_interface):
+        self.network_interface = network_interface
+        self.jobs = []
+
+    def addJob(self, job_id, name, path, nodes, numRanks=None, start="0ns", allocation="linear", cores=1, **workload):
+        num_nodes = len(nodes) if isinstance(nodes,list) else nodes
+        job = SwmJob(job_id,num_nodes)
+        job.network_interface = self.network_interface
+        job._numCores = cores
+        job.workload.name = name
+        job.workload.path = path
+        job.workload.numRanks = numRanks if numRanks else num_nodes * cores
+        job.workload.startTime = start
+        job.cfg = dict(workload.pop("cfg",{}))
+        for key, value in workload.items():
+            setattr(job.workload,key,value)
+        self.jobs.append( (job, nodes, allocation) )
+        return job
+
+    def readSchedule(self, path):
+        import json
+        with open(path) as f:
+            schedule = json.load(f)
+        for entry in schedule["jobs"]:
+            entry = dict(entry)
+            job_id = entry.pop("id")
+            name = entry.pop("name")
+            workload_path = entry.pop("path")
+            nodes = entry.pop("nodes")
+            self.addJob(job_id, name, workload_path, nodes, entry.pop("numRanks",None), entry.pop("start","0ns"),
+                    entry.pop("allocation","linear"), entry.pop("cores",1), **entry)
+
+    def allocate(self, system, num_nodes):
+        # jobs with explicit node lists go first so the others don't take their nodes
+        used = 0
+        for job, nodes, allocation in sorted(self.jobs, key=lambda x: not isinstance(x[1],list)):
+            if isinstance(nodes,list):
+                system.allocateNodes(job,"indexed",nodes)
+            else:
+                system.allocateNodes(job,allocation)
+            used += job.size
+            print("SwmSchedule: job %d %s on %d nodes starting at %s"%(job.job_id,job.workload.name,job.size,job.workload.startTime))
+
+        if used < num_nodes:
+            empty = EmptyJob(max(job.job_id for job, n, a in self.jobs) + 1, num_nodes - used)
+            empty.network_interface = self.network_interface
+            system.allocateNodes(empty,"linear")
+
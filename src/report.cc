@@ -0,0 +1,48 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+#include <sstream>
+#include "report.h"
+
+using namespace SST;
+
+std::string Swm::jobFileName( const std::string& path, int jobId )
+{
+    std::stringstream name;
+    name << path << "." << jobId;
+    if ( Simulation::getSimulation()->getNumRanks().rank > 1 ) {
+        name << "." << Simulation::getSimulation()->getRank().rank;
+    }
+    return name.str();
+}
+
+FILE* Swm::openJobFile( Output& output, const std::string& path, int jobId, const char* mode, const char* what )
+{
+    std::string name = jobFileName( path, jobId );
+    FILE* fp = fopen( name.c_str(), mode );
+    if ( NULL == fp ) {
+        output.fatal(CALL_INFO,-1,"could not open %s file %s\n",what,name.c_str());
+    }
+    return fp;
+}
+
+void Swm::requireOneProcess( Output& output, const char* feature )
+{
+    if ( Simulation::getSimulation()->getNumRanks().rank > 1 ) {
+        output.fatal(CALL_INFO,-1,"%s needs SST to run in one process\n",feature);
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_REPORT_H
+#define _SWM_REPORT_H
+
+#include <sst/core/output.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace SST {
+namespace Swm {
+
+// State shared by the ranks of a job simulated in this process. A rank joins when it is
+// built and leaves when it finishes, passing a function that folds its results into the
+// job's. The last rank of the job to leave also runs the report on the folded results.
+template< class Data >
+class JobReport {
+  public:
+    void join( int jobId ) {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        ++m_jobs[jobId].users;
+    }
+
+    template< class Fold, class Report >
+    void leave( int jobId, Fold fold, Report report ) {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        Job& job = m_jobs[jobId];
+        fold( job.data );
+        if ( 0 == --job.users ) {
+            report( job.data );
+            m_jobs.erase( jobId );
+        }
+    }
+
+  private:
+    struct Job {
+        Job() : users(0) {}
+        int     users;
+        Data    data;
+    };
+    std::map<int,Job> m_jobs;
+    std::mutex m_mutex;
+};
+
+// path.jobId, with the SST rank appended when SST runs on more than one process as each
+// process only sees the ranks it simulated
+std::string jobFileName( const std::string& path, int jobId );
+
+// opens jobFileName( path, jobId ), fatal if it can't
+FILE* openJobFile( Output& output, const std::string& path, int jobId, const char* mode, const char* what );
+
+// fatal when SST runs on more than one process, for features whose shared tables need
+// every rank of a job to be in this one
+void requireOneProcess( Output& output, const char* feature );
+
+}
+}
+
+#endif
@@ -0,0 +1,54 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+
+#include "responses.h"
+#include "report.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<Responses::Key,std::deque<uint64_t> > Responses::m_entries;
+std::mutex Responses::m_mutex;
+
+void Responses::expect( int jobId, int src, int dst, const Communicators::Members* comm, uint32_t tag, uint64_t bytes )
+{
+    if ( Simulation::getSimulation()->getNumRanks().rank > 1 ) {
+        if ( 0 == bytes ) {
+            return;
+        }
+        Output output("Responses::@p():@l ", 0, 0, Output::STDOUT);
+        requireOneProcess( output, "response traffic" );
+    }
+    std::lock_guard<std::mutex> lck(m_mutex);
+    m_entries[ Key( jobId, src, dst, comm, tag ) ].push_back( bytes );
+}
+
+bool Responses::take( int jobId, int src, int dst, const Communicators::Members* comm, uint32_t tag, uint64_t& bytes )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    auto iter = m_entries.find( Key( jobId, src, dst, comm, tag ) );
+    if ( iter == m_entries.end() ) {
+        return false;
+    }
+    bytes = iter->second.front();
+    iter->second.pop_front();
+    if ( iter->second.empty() ) {
+        m_entries.erase( iter );
+    }
+    return true;
+}
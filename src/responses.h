@@ -0,0 +1,52 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_RESPONSES_H
+#define _SWM_RESPONSES_H
+
+#include <sst/core/output.h>
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "communicator.h"
+
+namespace SST {
+namespace Swm {
+
+// Hermes messages only carry a size and a tag, so a rank that sends a request leaves its
+// response bytes here for the receiving rank to pick up when the request arrives.
+// Messages between a pair of ranks with the same communicator and tag are matched in
+// order so a FIFO per pair is enough, every message has an entry, 0 for no response, to
+// keep it in step with the receives. Ranks are world ranks and a
+// communicator is its interned member list, comm_ids are only meaningful to the rank
+// that holds them.
+class Responses {
+  public:
+    static void expect( int jobId, int src, int dst, const Communicators::Members* comm, uint32_t tag, uint64_t bytes );
+    static bool take( int jobId, int src, int dst, const Communicators::Members* comm, uint32_t tag, uint64_t& bytes );
+
+  private:
+    typedef std::tuple<int,int,int,const Communicators::Members*,uint32_t> Key;
+    static std::map<Key,std::deque<uint64_t> > m_entries;
+    static std::mutex m_mutex;
+};
+
+}
+}
+
+#endif
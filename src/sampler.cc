@@ -0,0 +1,99 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+
+#include "sampler.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<int,Sampler::Job> Sampler::m_jobs;
+std::mutex Sampler::m_mutex;
+
+Sampler::Sampler( int jobId, int rank, int numRanks, int warmup, int period, AnalyticModel model,
+        uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_model(model), m_jobId(jobId), m_rank(rank), m_numRanks(numRanks), m_warmup(warmup), m_period(period),
+    m_fastForward(false), m_iteration(-1), m_iterationStart(0), m_exitTime(0),
+    m_numDetailed(0), m_sum(0), m_sumSq(0), m_numSkipped(0), m_skippedTime(0)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Sampler::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    if ( m_period < 1 ) {
+        m_output.fatal(CALL_INFO,-1,"samplePeriod must be greater than 0\n");
+    }
+}
+
+// called on the SST thread when the call after the mark starts, Convert queues the marks
+void Sampler::mark( int tag, SimTime_t now )
+{
+    if ( m_iteration >= 0 ) {
+        SimTime_t time = now - m_iterationStart;
+        if ( m_fastForward ) {
+            ++m_numSkipped;
+            m_skippedTime += time;
+        } else {
+            ++m_numDetailed;
+            m_sum += time;
+            m_sumSq += (double) time * time;
+        }
+    }
+
+    ++m_iteration;
+    m_iterationStart = now;
+    m_fastForward = ! ( m_iteration < m_warmup || 0 == ( m_iteration - m_warmup ) % m_period );
+
+    m_output.debug(CALL_INFO, 1, SWM_SAMPLER_DBG_MASK,"tag=%d iteration=%d %s\n",tag,m_iteration,m_fastForward ? "fast forward":"detailed");
+}
+
+void Sampler::exit( SimTime_t now )
+{
+    // everything after the last mark belongs to the last iteration
+    mark( -1, now );
+    m_fastForward = false;
+    m_exitTime = now;
+}
+
+void Sampler::finish()
+{
+    double mean = m_numDetailed ? m_sum / m_numDetailed : 0;
+    double error = 0;
+    if ( m_numDetailed > 1 ) {
+        double var = ( m_sumSq - m_numDetailed * mean * mean ) / ( m_numDetailed - 1 );
+        error = 1.96 * sqrt( std::max( var, 0.0 ) / m_numDetailed ) * m_numSkipped;
+    }
+    double estimate = (double) ( m_exitTime - m_skippedTime ) + m_numSkipped * mean;
+
+    m_output.debug(CALL_INFO, 1, SWM_SAMPLER_DBG_MASK,"detailed=%d skipped=%d estimate=%.0f ns +/- %.0f\n",
+            m_numDetailed,m_numSkipped,estimate,error);
+
+    std::lock_guard<std::mutex> lck(m_mutex);
+    Job& job = m_jobs[m_jobId];
+    if ( estimate >= job.estimate ) {
+        job.estimate = estimate;
+        job.error = error;
+        job.numDetailed = m_numDetailed;
+        job.numSkipped = m_numSkipped;
+    }
+    job.simulated = std::max( job.simulated, m_exitTime );
+
+    if ( ++job.numFinished == m_numRanks ) {
+        m_output.output("job %d: simulated %" PRIu64 " ns, %d of %d iterations detailed, extrapolated runtime %.0f ns +/- %.0f ns (95%% confidence)%s\n",
+                m_jobId, job.simulated, job.numDetailed, job.numDetailed + job.numSkipped, job.estimate, job.error,
+                job.numDetailed > 1 ? "" : ", need 2 detailed iterations for a confidence estimate");
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_SAMPLER_H
+#define _SWM_SAMPLER_H
+
+#include <sst/core/output.h>
+
+#include <map>
+#include <mutex>
+
+#include "analytic.h"
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Sampled simulation over the iterations a skeleton marks with SWM_Mark_Iteration().
+// The first "warmup" iterations and every "period"th one after that are simulated in
+// detail, in the others compute is still simulated but communication completes by
+// the analytic model. At exit the time spent in fast forwarded iterations is replaced
+// by the mean of the detailed ones.
+class Sampler {
+  public:
+    Sampler( int jobId, int rank, int numRanks, int warmup, int period, AnalyticModel model,
+            uint32_t verboseLevel, uint32_t verboseMask );
+
+    void mark( int tag, SimTime_t now );
+    void exit( SimTime_t now );
+    void finish();
+
+    bool fastForward()      { return m_fastForward; }
+    AnalyticModel& model()  { return m_model; }
+
+  private:
+    Output          m_output;
+    AnalyticModel   m_model;
+    int             m_jobId;
+    int             m_rank;
+    int             m_numRanks;
+    int             m_warmup;
+    int             m_period;
+    bool            m_fastForward;
+    int             m_iteration;
+    SimTime_t       m_iterationStart;
+    SimTime_t       m_exitTime;
+
+    // detailed iteration times, and the fast forwarded ones
+    int             m_numDetailed;
+    double          m_sum;
+    double          m_sumSq;
+    int             m_numSkipped;
+    SimTime_t       m_skippedTime;
+
+    struct Job {
+        Job() : numFinished(0), numDetailed(0), numSkipped(0), estimate(0), error(0), simulated(0) {}
+        int numFinished;
+        int numDetailed;
+        int numSkipped;
+        double estimate;
+        double error;
+        SimTime_t simulated;
+    };
+    static std::map<int,Job> m_jobs;
+    static std::mutex m_mutex;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,105 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+
+#include "shm.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<int,std::map<int,Shm::Location> > Shm::m_locations;
+std::mutex Shm::m_mutex;
+
+Shm::Shm( int jobId, int nodeId, int coreId, double bandwidth, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_nodeId(nodeId), m_coreId(coreId), m_rank(-1), m_nsPerByte( 1e9 / bandwidth ),
+    m_verboseLevel(verboseLevel), m_verboseMask(verboseMask)
+{
+}
+
+void Shm::setup( int rank, Handler handler )
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Shm::@p():@l ",m_jobId,rank);
+    m_output.init(buffer, m_verboseLevel, m_verboseMask, Output::STDOUT);
+
+    m_rank = rank;
+    m_handler = handler;
+    Location location = { m_nodeId, m_coreId };
+    std::lock_guard<std::mutex> lck(m_mutex);
+    m_locations[m_jobId][rank] = location;
+}
+
+// ranks on other nodes, or in another SST process, are not known here
+bool Shm::local( int rank )
+{
+    if ( rank == m_rank ) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lck(m_mutex);
+    std::map<int,Location>& ranks = m_locations[m_jobId];
+    auto iter = ranks.find( rank );
+    return iter != ranks.end() && iter->second.nodeId == m_nodeId &&
+        iter->second.coreId < (int) m_links.size() && m_links[iter->second.coreId];
+}
+
+const Shm::Location& Shm::location( int rank )
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    return m_locations[m_jobId].at( rank );
+}
+
+SimTime_t Shm::send( int dst, const Communicators::Members* comm, int tag, uint64_t bytes )
+{
+    SimTime_t copy = bytes * m_nsPerByte;
+    m_output.debug(CALL_INFO, 1, SWM_SHM_DBG_MASK,"dst=%d comm=%p tag=%#x bytes=%" PRIu64 " copy=%" PRIu64 " ns\n",dst,comm,tag,bytes,copy);
+    m_links[ location( dst ).coreId ]->send( copy, new ShmEvent( m_rank, comm, tag, bytes ) );
+    return copy;
+}
+
+bool Shm::recv( int src, const Communicators::Members* comm, int tag, uint32_t id, int* matchedTag )
+{
+    Posted posted = { src, comm, tag, id };
+    for ( auto iter = m_unexpected.begin(); iter != m_unexpected.end(); ++iter ) {
+        if ( matches( posted, *iter ) ) {
+            m_output.debug(CALL_INFO, 1, SWM_SHM_DBG_MASK,"src=%d comm=%p tag=%#x matched\n",src,comm,iter->tag);
+            *matchedTag = iter->tag;
+            m_unexpected.erase( iter );
+            return true;
+        }
+    }
+    m_output.debug(CALL_INFO, 1, SWM_SHM_DBG_MASK,"src=%d comm=%p tag=%#x id=%u posted\n",src,comm,tag,id);
+    m_posted.push_back( posted );
+    return false;
+}
+
+void Shm::handleEvent( Event* ev )
+{
+    ShmEvent* event = static_cast<ShmEvent*>(ev);
+    Message msg = { event->src, event->comm, event->tag };
+    delete ev;
+
+    for ( auto iter = m_posted.begin(); iter != m_posted.end(); ++iter ) {
+        if ( matches( *iter, msg ) ) {
+            uint32_t id = iter->id;
+            m_output.debug(CALL_INFO, 1, SWM_SHM_DBG_MASK,"src=%d comm=%p tag=%#x id=%u arrived\n",msg.src,msg.comm,msg.tag,id);
+            m_posted.erase( iter );
+            m_handler( id, msg.tag );
+            return;
+        }
+    }
+    m_output.debug(CALL_INFO, 1, SWM_SHM_DBG_MASK,"src=%d comm=%p tag=%#x unexpected\n",msg.src,msg.comm,msg.tag);
+    m_unexpected.push_back( msg );
+}
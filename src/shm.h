@@ -0,0 +1,119 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _SWM_SHM_H
+#define _SWM_SHM_H
+
+#include <sst/core/event.h>
+#include <sst/core/link.h>
+#include <sst/core/output.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "dbg.h"
+#include "communicator.h"
+
+namespace SST {
+namespace Swm {
+
+class ShmEvent : public SST::Event {
+  public:
+    ShmEvent( int src, const Communicators::Members* comm, int tag, uint64_t bytes ) : src(src), comm(comm), tag(tag), bytes(bytes) {}
+    int src;
+    const Communicators::Members* comm;
+    int tag;
+    uint64_t bytes;
+    NotSerializable(ShmEvent)
+};
+
+// Messages between ranks that share a node, without the NIC. The ranks on a node are
+// connected by a link per pair. A message is a copy at the sender that takes
+// bytes / bandwidth, it then arrives after the link's latency. Receives name their
+// source and are matched in the order they are posted, by source, communicator and
+// tag. Sources are world ranks, communicators are their interned member lists.
+class Shm {
+  public:
+    // reports a posted receive that matched, with the tag of the message
+    typedef std::function<void(uint32_t id, int tag)> Handler;
+
+    Shm( int jobId, int nodeId, int coreId, double bandwidth, uint32_t verboseLevel, uint32_t verboseMask );
+
+    // the link to the rank on core coreId of the node
+    void addLink( int coreId, Link* link ) {
+        if ( coreId >= (int) m_links.size() ) {
+            m_links.resize( coreId + 1, NULL );
+        }
+        m_links[coreId] = link;
+    }
+    void setup( int rank, Handler handler );
+    void handleEvent( Event* );
+
+    bool local( int rank );
+
+    // returns the time the sender is busy with the copy
+    SimTime_t send( int dst, const Communicators::Members* comm, int tag, uint64_t bytes );
+
+    // true if a message that already arrived matches, otherwise the receive is posted
+    // and the handler is called with id when one does
+    bool recv( int src, const Communicators::Members* comm, int tag, uint32_t id, int* matchedTag );
+
+  private:
+    struct Message {
+        int src;
+        const Communicators::Members* comm;
+        int tag;
+    };
+    struct Posted {
+        int src;
+        const Communicators::Members* comm;
+        int tag;
+        uint32_t id;
+    };
+    static bool matches( const Posted& posted, const Message& msg ) {
+        return posted.src == msg.src && posted.comm == msg.comm && ( posted.tag == -1 || posted.tag == msg.tag );
+    }
+
+    Output  m_output;
+    int     m_jobId;
+    int     m_nodeId;
+    int     m_coreId;
+    int     m_rank;
+    double  m_nsPerByte;
+    uint32_t m_verboseLevel;
+    uint32_t m_verboseMask;
+    Handler m_handler;
+    std::vector<Link*>  m_links;
+    std::list<Message>  m_unexpected;
+    std::list<Posted>   m_posted;
+
+    // where each rank of a job runs, node and core, filled in at setup
+    struct Location {
+        int nodeId;
+        int coreId;
+    };
+    const Location& location( int rank );
+    static std::map<int,std::map<int,Location> > m_locations;
+    static std::mutex m_mutex;
+};
+
+}
+}
+
+#endif
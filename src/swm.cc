@@ -57,7 +57,7 @@ public:
 using namespace SST;
 using namespace SST::Swm;
 
-SwmComponent::SwmComponent(ComponentId_t id, Params& params ) : Component( id )
+SwmComponent::SwmComponent(ComponentId_t id, Params& params ) : Component( id ), m_shmemapi(NULL), m_workload(NULL), m_stage(0), m_comms(NULL), m_checkpoint(NULL), m_sampler(NULL), m_commMatrix(NULL), m_timeline(NULL), m_progress(NULL), m_affinity(NULL), m_shm(NULL), m_aggregator(NULL), m_phases(NULL), m_contention(NULL), m_fidelity(NULL), m_histograms(NULL)
 {
     m_verboseLevel = params.find<uint32_t>("verboseLevel",0);
     m_verboseMask = params.find<uint32_t>("verboseMask",-1);
@@ -66,16 +66,123 @@ SwmComponent::SwmComponent(ComponentId_t id, Params& params ) : Component( id )
 
     m_path = params.find<std::string>("path");
     m_workloadName = params.find<std::string>("name");
+    m_nativeWorkload = params.find<bool>("nativeWorkload",false);
+
+    m_checkpointPath = params.find<std::string>("checkpointPath","");
+    m_checkpointInterval = params.find<int>("checkpointInterval",1);
+    m_restartPath = params.find<std::string>("restartPath","");
+    m_commMatrixPath = params.find<std::string>("commMatrixPath","");
+    m_timelinePath = params.find<std::string>("timelinePath","");
+    m_timelineFormat = params.find<std::string>("timelineFormat","chrome");
+    m_timelineBuffer = params.find<size_t>("timelineBuffer",4096);
+    // the per phase breakdown of SWM_Mark() phases is kept when set
+    m_phasePath = params.find<std::string>("phasePath","");
+    // latency and bandwidth histograms of the communication calls are kept when set
+    m_histogramPath = params.find<std::string>("histogramPath","");
 
     char buffer[100];
     snprintf(buffer,100,"SwmComponent::@p():@l ");
     Output output(buffer, m_verboseLevel, m_verboseMask, Output::STDOUT);
 
+    // "lammps,milc,milc" runs the workloads in turn, chainPaths lists a config file for each
+    // and defaults to path
+    std::string name;
+    std::stringstream chain( params.find<std::string>("chain","") );
+    while ( std::getline( chain, name, ',' ) ) {
+        m_chain.push_back( name );
+    }
+    std::stringstream chainPaths( params.find<std::string>("chainPaths","") );
+    while ( std::getline( chainPaths, name, ',' ) ) {
+        m_chainPaths.push_back( name );
+    }
+    if ( m_chain.empty() ) {
+        m_chain.push_back( m_workloadName );
+    }
+    if ( m_chainPaths.empty() ) {
+        m_chainPaths.assign( m_chain.size(), m_path );
+    }
+    if ( m_chainPaths.size() != m_chain.size() ) {
+        output.fatal(CALL_INFO,-1,"chain has %zu workloads but chainPaths has %zu files\n",m_chain.size(),m_chainPaths.size()); 
+    }
+
+    // cfg.<key> replaces jobs.cfg.<key> in the workload's file
+    Params cfg = params.find_prefix_params("cfg.");
+    for ( auto& key : cfg.getKeys() ) {
+        m_cfg[key] = cfg.find<std::string>(key);
+    }
+    m_bytesScale = params.find<double>("bytesScale",1);
+    m_computeScale = params.find<double>("computeScale",1);
+    if ( m_bytesScale < 0 || m_computeScale < 0 ) {
+        output.fatal(CALL_INFO,-1,"bytesScale and computeScale can't be negative\n"); 
+    }
+
+    // memory bound share of compute time and the number of ranks a node's memory bandwidth
+    // serves at full speed, with a share the ranks of a node slow each other's computes
+    m_computeMemoryFraction = params.find<double>("computeMemoryFraction",0);
+    m_computeSaturation = params.find<int>("computeSaturation",1);
+    m_nodeId = params.find<int>("nodeId",-1);
+    if ( m_computeMemoryFraction < 0 || m_computeMemoryFraction > 1 ) {
+        output.fatal(CALL_INFO,-1,"computeMemoryFraction must be between 0 and 1\n"); 
+    }
+    if ( m_computeMemoryFraction > 0 && ( m_computeSaturation < 1 || -1 == m_nodeId ) ) {
+        output.fatal(CALL_INFO,-1,"compute contention needs computeSaturation of at least 1 and the rank's nodeId\n"); 
+    }
+
     m_numRanks = params.find<int>("numRanks",0);
     if ( ! m_numRanks ) {
         output.fatal(CALL_INFO,-1,"numRanks was not set\n"); 
     }
 
+    // jobs can arrive after the simulation starts
+    UnitAlgebra startTime( params.find<std::string>("startTime","0ns") );
+    if ( ! startTime.hasUnits("s") ) {
+        output.fatal(CALL_INFO,-1,"startTime must be a time\n"); 
+    }
+    m_startDelay = ( startTime / UnitAlgebra("1ns") ).getRoundedValue();
+
+    // a heartbeat every progressInterval of simulated time, printed if progressWallInterval seconds have passed
+    UnitAlgebra progressInterval( params.find<std::string>("progressInterval","0ns") );
+    if ( ! progressInterval.hasUnits("s") ) {
+        output.fatal(CALL_INFO,-1,"progressInterval must be a time\n"); 
+    }
+    m_progressInterval = ( progressInterval / UnitAlgebra("1ns") ).getRoundedValue();
+    m_progressWallInterval = params.find<double>("progressWallInterval",0);
+    m_progressSlowest = params.find<int>("progressSlowest",4);
+
+    m_workloadAffinity = params.find<std::string>("workloadAffinity","none");
+    if ( 0 != m_workloadAffinity.compare("none") && 0 != m_workloadAffinity.compare("core") &&
+            0 != m_workloadAffinity.compare("numa") ) {
+        output.fatal(CALL_INFO,-1,"unknown workloadAffinity %s\n",m_workloadAffinity.c_str()); 
+    }
+
+    // sends of at most aggregateBytes are batched per destination
+    m_aggregateBytes = params.find<uint64_t>("aggregateBytes",0);
+    m_aggregateLimit = params.find<uint64_t>("aggregateLimit",4096);
+    UnitAlgebra aggregateWindow( params.find<std::string>("aggregateWindow","1us") );
+    if ( ! aggregateWindow.hasUnits("s") ) {
+        output.fatal(CALL_INFO,-1,"aggregateWindow must be a time\n"); 
+    }
+    m_aggregateWindow = ( aggregateWindow / UnitAlgebra("1ns") ).getRoundedValue();
+
+    // hybrid fidelity, only the detailedRanks are simulated through Hermes, communication
+    // that involves any other rank completes by the analytic model
+    m_detailedRanks = params.find<std::string>("detailedRanks","");
+    m_analyticLatency = params.find<double>("analyticLatency",1000);
+    m_analyticBandwidth = params.find<double>("analyticBandwidth",4);
+
+    m_samplePeriod = params.find<int>("samplePeriod",0);
+    m_sampleWarmup = params.find<int>("sampleWarmup",1);
+    std::string sampleModel = params.find<std::string>("sampleModel","instant");
+    if ( 0 == sampleModel.compare("analytic") ) {
+        m_sampleLatency = params.find<double>("sampleLatency",1000);
+        m_sampleBandwidth = params.find<double>("sampleBandwidth",4);
+    } else if ( 0 == sampleModel.compare("instant") ) {
+        m_sampleLatency = 0;
+        m_sampleBandwidth = 0;
+    } else {
+        output.fatal(CALL_INFO,-1,"unknown sampleModel %s\n",sampleModel.c_str()); 
+    }
+
     m_os = loadUserSubComponent<OS>( "OS" );
     if( ! m_os ) {
 		output.fatal(CALL_INFO,-1,"Couldn't load the \"OS\" SubComponent\n"); 
@@ -91,6 +198,34 @@ SwmComponent::SwmComponent(ComponentId_t id, Params& params ) : Component( id )
 
     m_msgapi->setOS( m_os );
 
+    // optional, one-sided calls go through the SHMEM interface on a heap of this many bytes
+    m_shmemHeap = params.find<size_t>("shmemHeap",0);
+    if ( m_shmemHeap ) {
+        m_shmemapi = loadAnonymousSubComponent<Shmem::Interface>( "firefly.hadesSHMEM", "", 0, ComponentInfo::SHARE_NONE, modParams );
+        if( ! m_shmemapi ) {
+            output.fatal(CALL_INFO,-1,"Couldn't load the \"firefly.hadesSHMEM\" SubComponent\n"); 
+        }
+        m_shmemapi->setOS( m_os );
+    }
+
+    // ranks on the same node are linked when the job gives them a shared memory path
+    int numCores = params.find<int>("numCores",1);
+    for ( int core = 0; core < numCores; core++ ) {
+        std::string port = "shm" + std::to_string(core);
+        if ( ! isPortConnected( port ) ) {
+            continue;
+        }
+        if ( ! m_shm ) {
+            UnitAlgebra bandwidth( params.find<std::string>("shmBandwidth","10GB/s") );
+            if ( ! bandwidth.hasUnits("B/s") ) {
+                output.fatal(CALL_INFO,-1,"shmBandwidth must be a bandwidth\n"); 
+            }
+            m_shm = new Shm( m_jobId, m_nodeId, params.find<int>("coreId",-1), bandwidth.getDoubleValue(),
+                    m_verboseLevel, m_verboseMask );
+        }
+        m_shm->addLink( core, configureLink( port, "1ns", new Event::Handler<Shm>(m_shm, &Shm::handleEvent) ) );
+    }
+
     m_selfLink = configureSelfLink("Self", "1ns", new Event::Handler<SwmComponent>(this, &SwmComponent::handleSelfEvent));
 
     m_tConv = Simulation::getSimulation()->getTimeLord()->getTimeConverter("1ns");
@@ -101,8 +236,23 @@ SwmComponent::SwmComponent(ComponentId_t id, Params& params ) : Component( id )
 }
 
 SwmComponent::~SwmComponent() {
-	delete m_workload;
+    for ( auto stage : m_stages ) {
+	    delete stage;
+    }
     delete m_convert;
+    delete m_comms;
+    delete m_checkpoint;
+    delete m_sampler;
+    delete m_commMatrix;
+    delete m_timeline;
+    delete m_progress;
+    delete m_affinity;
+    delete m_shm;
+    delete m_aggregator;
+    delete m_phases;
+    delete m_contention;
+    delete m_fidelity;
+    delete m_histograms;
 }
 
 void SwmComponent::setup() {
@@ -115,33 +265,159 @@ void SwmComponent::setup() {
     snprintf(buffer,100,"@t:%d:%d:SwmComponent::@p():@l ",m_jobId,m_rank);
     m_output.init(buffer, m_verboseLevel, m_verboseMask, Output::STDOUT);
 
-	m_convert = new Convert( m_selfLink, m_msgapi, m_jobId, m_rank, m_verboseLevel, m_verboseMask );
+    m_comms = new Communicators( m_jobId, m_rank, m_numRanks, m_verboseLevel, m_verboseMask );
 
-    try {
-		m_workload = new Workload( m_convert, m_path, m_workloadName, m_numRanks, m_jobId, m_rank, m_verboseLevel, m_verboseMask );
+    if ( ! m_checkpointPath.empty() || ! m_restartPath.empty() ) {
+        m_checkpoint = new Checkpoint( m_jobId, m_rank, m_numRanks, m_checkpointPath, m_checkpointInterval, m_restartPath,
+                m_verboseLevel, m_verboseMask );
     }
-    catch(std::exception & e)
-    {
-		m_output.fatal(CALL_INFO,-1,"could not create workload=%s file=%s, \"%s\"\n",m_workloadName.c_str(),m_path.c_str(), e.what()); 
+
+    if ( m_samplePeriod ) {
+        m_sampler = new Sampler( m_jobId, m_rank, m_numRanks, m_sampleWarmup, m_samplePeriod,
+                AnalyticModel( m_sampleLatency, m_sampleBandwidth ), m_verboseLevel, m_verboseMask );
+    }
+
+    if ( ! m_commMatrixPath.empty() ) {
+        m_commMatrix = new CommMatrix( m_jobId, m_rank, m_numRanks, m_comms, m_commMatrixPath, m_verboseLevel, m_verboseMask );
+    }
+
+    if ( ! m_timelinePath.empty() ) {
+        m_timeline = new Timeline( m_jobId, m_rank, m_timelinePath, m_timelineFormat, m_timelineBuffer,
+                Convert::functionNames(), Convert::numFunctions(), m_verboseLevel, m_verboseMask );
     }
 
+    if ( m_progressInterval ) {
+        m_progress = new Progress( m_jobId, m_rank );
+    }
+
+    if ( 0 != m_workloadAffinity.compare("none") ) {
+        m_affinity = new Affinity( 0 == m_workloadAffinity.compare("numa") ? Affinity::Numa : Affinity::Core,
+                m_jobId, m_rank, m_verboseLevel, m_verboseMask );
+    }
+
+    if ( m_aggregateBytes ) {
+        m_aggregator = new Aggregator( m_jobId, m_rank, m_aggregateBytes, m_aggregateLimit, m_aggregateWindow,
+                m_verboseLevel, m_verboseMask );
+    }
+
+    if ( ! m_phasePath.empty() ) {
+        m_phases = new Phases( m_jobId, m_rank, m_phasePath, m_verboseLevel, m_verboseMask );
+    }
+
+    if ( m_computeMemoryFraction > 0 ) {
+        m_contention = new Contention( m_jobId, m_rank, m_nodeId, m_computeMemoryFraction, m_computeSaturation,
+                m_verboseLevel, m_verboseMask );
+    }
+
+    if ( ! m_detailedRanks.empty() ) {
+        m_fidelity = new Fidelity( m_jobId, m_rank, m_numRanks, m_detailedRanks,
+                AnalyticModel( m_analyticLatency, m_analyticBandwidth ), m_verboseLevel, m_verboseMask );
+    }
+
+    if ( ! m_histogramPath.empty() ) {
+        m_histograms = new Histograms( m_jobId, m_rank, m_histogramPath, Convert::functionNames(), Convert::numFunctions(),
+                m_verboseLevel, m_verboseMask );
+    }
+
+    Convert::Features features;
+    features.shmem = m_shmemapi;
+    features.shmemHeap = m_shmemHeap;
+    features.comms = m_comms;
+    features.checkpoint = m_checkpoint;
+    features.sampler = m_sampler;
+    features.commMatrix = m_commMatrix;
+    features.timeline = m_timeline;
+    features.progress = m_progress;
+    features.shm = m_shm;
+    features.aggregator = m_aggregator;
+    features.phases = m_phases;
+    features.contention = m_contention;
+    features.fidelity = m_fidelity;
+    features.histograms = m_histograms;
+	m_convert = new Convert( m_selfLink, m_msgapi, m_jobId, m_rank, features, m_verboseLevel, m_verboseMask );
+    m_convert->setScale( m_bytesScale, m_computeScale );
+
+    for ( size_t i = 0; i < m_chain.size(); i++ ) {
+        try {
+		    m_stages.push_back( new Workload( m_convert, m_affinity, m_chainPaths[i], m_chain[i], m_nativeWorkload, m_cfg, m_numRanks, m_jobId, m_rank,
+                        m_verboseLevel, m_verboseMask ) );
+        }
+        catch(std::exception & e)
+        {
+		    m_output.fatal(CALL_INFO,-1,"could not create workload=%s file=%s, \"%s\"\n",m_chain[i].c_str(),m_chainPaths[i].c_str(), e.what()); 
+        }
+    }
+    m_workload = m_stages.front();
+
     m_msgapi->setup();
+    if ( m_shmemapi ) {
+        m_shmemapi->setup();
+    }
+
+    m_output.debug(CALL_INFO, 1, SWM_DBG_MASK,"start workload in %" PRIu64 " ns\n",m_startDelay);
+    m_selfLink->send( m_startDelay, new SwmEvent(SwmEvent::Type::StartWorkload) );
 
-    m_selfLink->send( new SwmEvent(SwmEvent::Type::StartWorkload) );
+    if ( m_progressInterval && Progress::claimReporter() ) {
+        m_selfLink->send( m_progressInterval, new SwmEvent(SwmEvent::Type::Heartbeat) );
+    }
 
     m_output.debug(CALL_INFO, 1, SWM_DBG_MASK,"return\n");
 }
 
+void SwmComponent::finish() {
+    m_workload->stop();
+    if ( m_sampler ) {
+        m_sampler->finish();
+    }
+    if ( m_commMatrix ) {
+        m_commMatrix->finish();
+    }
+    if ( m_timeline ) {
+        m_timeline->finish();
+    }
+    if ( m_phases ) {
+        m_phases->finish();
+    }
+    if ( m_histograms ) {
+        m_histograms->finish();
+    }
+}
+
+void SwmComponent::startStage() {
+    m_output.debug(CALL_INFO, 1, SWM_DBG_MASK,"start %s, stage %zu of %zu\n",m_chain[m_stage].c_str(),m_stage + 1,m_stages.size());
+    m_convert->nextStage( m_stage + 1 == m_stages.size() );
+    m_workload->start();
+}
+
 void SwmComponent::handleSelfEvent( Event* ev ) {
     SwmEvent* event = static_cast< SwmEvent* >(ev);
     m_output.debug(CALL_INFO, 2, SWM_DBG_MASK,"type=%d\n",event->type);
     switch ( event->type ) {
       case SwmEvent::Type::StartWorkload:
-        m_workload->start();
+        startStage();
+        break;
+      case SwmEvent::Type::StageDone:
+        m_workload->join();
+        m_workload = m_stages[++m_stage];
+        startStage();
         break;
       case SwmEvent::Type::MP_Returned:
         m_convert->MP_returned(event->arg1,event->arg2);
         break;
+      case SwmEvent::Type::Resume:
+        m_convert->issueWork();
+        break;
+      case SwmEvent::Type::ComputeDone:
+        m_convert->computeDone(event->arg1);
+        break;
+      case SwmEvent::Type::Poll:
+        m_convert->poll(event->arg1);
+        break;
+      case SwmEvent::Type::Heartbeat:
+        if ( Progress::report( getCurrentSimTimeNano(), m_progressWallInterval, m_progressSlowest, m_output ) ) {
+            m_selfLink->send( m_progressInterval, new SwmEvent(SwmEvent::Type::Heartbeat) );
+        }
+        break;
       case SwmEvent::Type::Exit:
         m_output.debug(CALL_INFO, 1, SWM_DBG_MASK,"call primaryComponentOKToEndSim()\n",event->type);
         primaryComponentOKToEndSim();
@@ -21,9 +21,24 @@
 #include <sst/core/timeConverter.h>
 #include <sst/core/timeLord.h>
 #include <sst/core/output.h>
+#include <sst/core/unitAlgebra.h>
 #include <sst/elements/hermes/msgapi.h>
+#include <sst/elements/hermes/shmemapi.h>
 
 #include "workload.h"
+#include "affinity.h"
+#include "aggregate.h"
+#include "checkpoint.h"
+#include "commmatrix.h"
+#include "communicator.h"
+#include "contention.h"
+#include "fidelity.h"
+#include "histogram.h"
+#include "phases.h"
+#include "progress.h"
+#include "sampler.h"
+#include "shm.h"
+#include "timeline.h"
 #include "event.h"
 #include "dbg.h"
 
@@ -44,7 +59,9 @@ class SwmComponent : public Component {
         COMPONENT_CATEGORY_UNCATEGORIZED
     )
     SST_ELI_DOCUMENT_PARAMS()
-    SST_ELI_DOCUMENT_PORTS()
+    SST_ELI_DOCUMENT_PORTS(
+        {"shm%(numCores)d", "Link to the rank on core %d of the node, messages to it don't go through the NIC", {}}
+    )
 
   public:
     SwmComponent( ComponentId_t id, Params& params );
@@ -53,24 +70,76 @@ class SwmComponent : public Component {
     void init( unsigned int phase ) { m_os->_componentInit(phase); }
 
 	void setup();
-    void finish() { m_workload->stop(); }
+    void finish();
 
   private:
 
     void handleSelfEvent( SST::Event* ev );
+    void startStage();
 
     SST::TimeConverter* m_tConv;
 	int				m_rank;
 	int				m_jobId;
     OS*				m_os;
 	MP::Interface*	m_msgapi;
+    Shmem::Interface*   m_shmemapi;
+    size_t          m_shmemHeap;
     Link*	  		m_selfLink;
 	Output			m_output;
 	Workload*		m_workload;
+    // a chained workload runs its stages one after the other on the same ranks
+    std::vector<Workload*>  m_stages;
+    size_t          m_stage;
     Convert*        m_convert;
+    Communicators*  m_comms;
+    Checkpoint*     m_checkpoint;
+    std::string     m_checkpointPath;
+    std::string     m_restartPath;
+    int             m_checkpointInterval;
+    Sampler*        m_sampler;
+    int             m_sampleWarmup;
+    int             m_samplePeriod;
+    double          m_sampleLatency;
+    double          m_sampleBandwidth;
+    CommMatrix*     m_commMatrix;
+    std::string     m_commMatrixPath;
+    Timeline*       m_timeline;
+    std::string     m_timelinePath;
+    std::string     m_timelineFormat;
+    size_t          m_timelineBuffer;
+    Progress*       m_progress;
+    Affinity*       m_affinity;
+    Shm*            m_shm;
+    Aggregator*     m_aggregator;
+    Phases*         m_phases;
+    Contention*     m_contention;
+    Fidelity*       m_fidelity;
+    std::string     m_detailedRanks;
+    double          m_analyticLatency;
+    double          m_analyticBandwidth;
+    std::string     m_phasePath;
+    Histograms*     m_histograms;
+    std::string     m_histogramPath;
+    uint64_t        m_aggregateBytes;
+    uint64_t        m_aggregateLimit;
+    SimTime_t       m_aggregateWindow;
+    std::string     m_workloadAffinity;
+    SimTime_t       m_progressInterval;
+    double          m_progressWallInterval;
+    int             m_progressSlowest;
     std::string     m_workloadName;
+    bool            m_nativeWorkload;
     std::string     m_path;
+    std::vector<std::string>    m_chain;
+    std::vector<std::string>    m_chainPaths;
+    std::map<std::string,std::string>   m_cfg;
+    double          m_bytesScale;
+    double          m_computeScale;
+    double          m_computeMemoryFraction;
+    int             m_computeSaturation;
+    int             m_nodeId;
     int             m_numRanks;
+    SimTime_t       m_startDelay;
     int             m_verboseLevel;
     int             m_verboseMask;
 };
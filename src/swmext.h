@@ -0,0 +1,87 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_EXT_H
+#define _SWM_EXT_H
+
+#include <swm-include.h>
+
+// SWM calls provided by this element in addition to the ones in swm-include.h,
+// skeletons that use them include this file
+
+void SWM_Test(uint32_t req_id, int* flag);
+
+void SWM_Testall(int len, uint32_t * req_ids, int* flag);
+
+void SWM_Waitany(int len, uint32_t * req_ids, int* index);
+
+void SWM_Waitsome(int len, uint32_t * req_ids, int* outcount, int* indices);
+
+// marks the start of an iteration of the skeleton's main loop, all ranks have to mark
+// the same iterations at points where they have no communication outstanding
+void SWM_Mark_Iteration(SWM_TAG iter_tag);
+
+// starts phase phase_id, it lasts until the next mark, phases can be entered any number
+// of times. Time, bytes sent and communication wait are reported per phase at the end.
+void SWM_Mark(int phase_id);
+
+// Sub-communicators. comm_id 0 is the world communicator, new ones get ids in the
+// order a rank creates them. Ranks in a sub-communicator are numbered from 0 and
+// peers passed with its comm_id are ranks in it. A split with color SWM_UNDEFINED
+// returns SWM_COMM_NULL, a cartesian grid is laid out in row major order.
+#define SWM_COMM_NULL   -1
+#define SWM_UNDEFINED   -1
+
+void SWM_Comm_split(SWM_COMM_ID comm_id, int color, int key, SWM_COMM_ID* newcomm);
+
+void SWM_Comm_dup(SWM_COMM_ID comm_id, SWM_COMM_ID* newcomm);
+
+void SWM_Cart_sub(SWM_COMM_ID comm_id, int ndims, const int* dims, const int* remain_dims, SWM_COMM_ID* newcomm);
+
+void SWM_Comm_free(SWM_COMM_ID comm_id);
+
+int SWM_Comm_rank(SWM_COMM_ID comm_id);
+
+int SWM_Comm_size(SWM_COMM_ID comm_id);
+
+// One-sided calls, they need the shmemHeap parameter. Every rank allocates a symmetric heap
+// of that size at SWM_Init, pe is a rank in the world communicator and only the bytes moved
+// are modeled. The handle of a non-blocking call is waited on or tested like one from
+// SWM_Isend, it completes once all one-sided calls the rank made are complete at their target.
+void SWM_Put(SWM_PEER pe, SWM_BYTES bytes);
+
+void SWM_Get(SWM_PEER pe, SWM_BYTES bytes);
+
+void SWM_Put_nb(SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle);
+
+void SWM_Get_nb(SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle);
+
+// adds value to a word every rank has and returns what it held before
+void SWM_Fetch_add(SWM_PEER pe, long value, long* result);
+
+// orders the puts before it ahead of the ones after it, at each target
+void SWM_Fence();
+
+// Non-blocking collectives, the handle is waited on or tested like one from SWM_Isend.
+// They run one at a time in the order they were started and overlap with SWM_Compute
+// and tests of their handles, any other call waits for them to complete first.
+void SWM_Iallreduce(SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle);
+
+void SWM_Ibarrier(SWM_COMM_ID comm_id, uint32_t* handle);
+
+// bytes is what each rank sends to every other rank
+void SWM_Ialltoall(SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle);
+
+#endif
@@ -0,0 +1,315 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+
+#include <algorithm>
+
+#include "convert.h"
+#include "synthetic.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+bool SyntheticGenerator::runs( std::string name, bool native )
+{
+    if ( name == "uniform_random" || name == "bit_complement" || name == "transpose" || name == "stencil3d" ) {
+        return true;
+    }
+    return native && ( name == "incast" || name == "incast1" || name == "incast2" || name == "many_to_many" ||
+            name == "nearest_neighbor" );
+}
+
+SyntheticGenerator::SyntheticGenerator( std::string name, boost::property_tree::ptree& root, int numRanks, int rank,
+        double cpuFreq, int jobId, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_state(Init), m_numRanks(numRanks), m_rank(rank), m_cpuFreq(cpuFreq), m_iteration(0), m_pos(0), m_flag(0)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:SyntheticGenerator::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    m_iterations = root.get<int>("jobs.cfg.iteration_cnt",1);
+    m_computeDelay = root.get<double>("jobs.cfg.compute_delay",0);
+    m_reqBytes = root.get<uint64_t>("jobs.cfg.msg_req_bytes",0);
+    m_rspBytes = root.get<uint64_t>("jobs.cfg.msg_rsp_bytes",0);
+    m_scatteredStart = root.get<bool>("jobs.cfg.scattered_start",false);
+    m_startDelayMax = root.get<double>("jobs.cfg.start_delay_max",0);
+    m_randomOrder = root.get<bool>("jobs.cfg.randomize_communication_order",false);
+    m_fixedPairs = root.get<bool>("jobs.cfg.fixed_pairs",false);
+    m_seed = root.get<uint64_t>("jobs.cfg.seed",1);
+    m_reqVc = root.get<int>("jobs.cfg.request_vc",0);
+    m_rspVc = root.get<int>("jobs.cfg.response_vc",0);
+    m_testPoll = root.get<bool>("jobs.cfg.test_poll",false);
+    m_pollInterval = root.get<double>("jobs.cfg.poll_interval",0);
+    m_rng.seed( m_seed + rank );
+
+    if ( name.compare( 0, 6, "incast" ) == 0 ) {
+        m_pattern = Incast;
+        m_dst.push_back( root.get<int>("jobs.cfg.dst_rank_id",0) );
+        m_src = interval( root, "jobs.cfg.src_rank_id_interval", 0, numRanks - 1 );
+    } else if ( name == "many_to_many" ) {
+        m_pattern = ManyToMany;
+        m_src = interval( root, "jobs.cfg.src_rank_id_interval", 0, numRanks - 1 );
+        m_dst = interval( root, "jobs.cfg.dst_rank_id_interval", 0, numRanks - 1 );
+    } else if ( name == "nearest_neighbor" || name == "stencil3d" ) {
+        m_pattern = name == "stencil3d" ? Stencil3d : NearestNeighbor;
+        if ( root.get_child_optional("jobs.cfg.dim_length") ) {
+            for ( auto& value : root.get_child("jobs.cfg.dim_length") ) {
+                m_dims.push_back( value.second.get_value<int>() );
+            }
+        } else {
+            m_dims.push_back( numRanks );
+        }
+        int size = 1;
+        for ( auto dim : m_dims ) {
+            size *= dim;
+        }
+        if ( size != numRanks ) {
+            m_output.fatal(CALL_INFO,-1,"%s: dim_length covers %d ranks, the job has %d\n",name.c_str(),size,numRanks);
+        }
+        if ( Stencil3d == m_pattern && 3 != m_dims.size() ) {
+            m_output.fatal(CALL_INFO,-1,"stencil3d needs a dim_length with 3 dimensions\n");
+        }
+    } else if ( name == "uniform_random" ) {
+        m_pattern = UniformRandom;
+    } else if ( name == "bit_complement" ) {
+        m_pattern = BitComplement;
+        if ( numRanks & ( numRanks - 1 ) ) {
+            m_output.fatal(CALL_INFO,-1,"bit_complement needs a power of two number of ranks, not %d\n",numRanks);
+        }
+    } else if ( name == "transpose" ) {
+        m_pattern = Transpose;
+        int side = 0;
+        while ( ( side + 1 ) * ( side + 1 ) <= numRanks ) {
+            ++side;
+        }
+        if ( side * side != numRanks ) {
+            m_output.fatal(CALL_INFO,-1,"transpose needs a square number of ranks, not %d\n",numRanks);
+        }
+        m_dims.push_back( side );
+    } else {
+        m_output.fatal(CALL_INFO,-1,"no native workload %s\n",name.c_str());
+    }
+}
+
+std::vector<int> SyntheticGenerator::interval( boost::property_tree::ptree& root, const char* key, int lo, int hi )
+{
+    if ( root.get_child_optional( key ) ) {
+        std::vector<int> values;
+        for ( auto& value : root.get_child( key ) ) {
+            values.push_back( value.second.get_value<int>() );
+        }
+        if ( 2 != values.size() ) {
+            m_output.fatal(CALL_INFO,-1,"%s must be [first,last]\n",key);
+        }
+        lo = values[0];
+        hi = values[1];
+    }
+    std::vector<int> ranks;
+    for ( int i = lo; i <= hi && i < m_numRanks; i++ ) {
+        ranks.push_back( i );
+    }
+    return ranks;
+}
+
+static int64_t gcd( int64_t a, int64_t b )
+{
+    while ( b ) {
+        std::tie( a, b ) = std::make_tuple( b, a % b );
+    }
+    return a;
+}
+
+static int64_t modInverse( int64_t a, int64_t n )
+{
+    int64_t t = 0, newT = 1, r = n, newR = a;
+    while ( newR ) {
+        int64_t q = r / newR;
+        std::tie( t, newT ) = std::make_tuple( newT, t - q * newT );
+        std::tie( r, newR ) = std::make_tuple( newR, r - q * newR );
+    }
+    return t < 0 ? t + n : t;
+}
+
+// the ranks this rank exchanges with in an iteration, every pattern can tell who sends to a
+// rank without looking at the other ranks so setting up costs the same at any scale
+void SyntheticGenerator::peers( int iteration )
+{
+    m_recvFrom.clear();
+    m_sendTo.clear();
+
+    switch ( m_pattern ) {
+      case Incast:
+        if ( m_rank == m_dst[0] ) {
+            m_recvFrom = m_src;
+        } else if ( std::binary_search( m_src.begin(), m_src.end(), m_rank ) ) {
+            m_sendTo = m_dst;
+        }
+        break;
+      case ManyToMany:
+        // with fixed_pairs each source sends to one destination, otherwise to all of them
+        if ( std::binary_search( m_src.begin(), m_src.end(), m_rank ) && ! m_dst.empty() ) {
+            if ( m_fixedPairs ) {
+                m_sendTo.push_back( m_dst[ ( m_rank - m_src[0] ) % m_dst.size() ] );
+            } else {
+                m_sendTo = m_dst;
+            }
+        }
+        if ( std::binary_search( m_dst.begin(), m_dst.end(), m_rank ) ) {
+            for ( auto src : m_src ) {
+                if ( ! m_fixedPairs || (size_t) ( src - m_src[0] ) % m_dst.size() == (size_t) ( m_rank - m_dst[0] ) ) {
+                    m_recvFrom.push_back( src );
+                }
+            }
+        }
+        break;
+      case NearestNeighbor:
+        neighbors( false );
+        break;
+      case Stencil3d:
+        neighbors( true );
+        break;
+      case UniformRandom:
+        {
+            // a random permutation a * rank + b mod numRanks, drawn from the same seed on every rank
+            std::mt19937_64 rng( m_seed + iteration );
+            int64_t n = m_numRanks;
+            int64_t a, b;
+            do {
+                a = 1 + rng() % std::max( n - 1, (int64_t) 1 );
+            } while ( gcd( a, n ) != 1 );
+            b = rng() % n;
+            m_sendTo.push_back( ( a * m_rank + b ) % n );
+            m_recvFrom.push_back( modInverse( a, n ) * ( ( m_rank - b + n ) % n ) % n );
+        }
+        break;
+      case BitComplement:
+        m_sendTo.push_back( ( m_numRanks - 1 ) ^ m_rank );
+        m_recvFrom = m_sendTo;
+        break;
+      case Transpose:
+        m_sendTo.push_back( ( m_rank % m_dims[0] ) * m_dims[0] + m_rank / m_dims[0] );
+        m_recvFrom = m_sendTo;
+        break;
+    }
+
+    m_recvFrom.erase( std::remove( m_recvFrom.begin(), m_recvFrom.end(), m_rank ), m_recvFrom.end() );
+    m_sendTo.erase( std::remove( m_sendTo.begin(), m_sendTo.end(), m_rank ), m_sendTo.end() );
+    if ( m_randomOrder ) {
+        std::shuffle( m_sendTo.begin(), m_sendTo.end(), m_rng );
+    }
+    m_handles.resize( m_recvFrom.size() + m_sendTo.size() );
+}
+
+// the ranks one step away in each dimension of the torus m_dims, and with diagonals the
+// ones one step away in several dimensions, the exchange is symmetric
+void SyntheticGenerator::neighbors( bool diagonals )
+{
+    std::vector<int> coord( m_dims.size() );
+    for ( size_t i = 0, rank = m_rank; i < m_dims.size(); i++ ) {
+        coord[i] = rank % m_dims[i];
+        rank /= m_dims[i];
+    }
+
+    int numOffsets = 1;
+    for ( size_t i = 0; i < m_dims.size(); i++ ) {
+        numOffsets *= 3;
+    }
+    for ( int offset = 0; offset < numOffsets; offset++ ) {
+        int rank = 0, stride = 1, moved = 0;
+        for ( size_t i = 0, o = offset; i < m_dims.size(); i++, o /= 3 ) {
+            int step = (int) ( o % 3 ) - 1;
+            moved += step != 0;
+            rank += ( ( coord[i] + step + m_dims[i] ) % m_dims[i] ) * stride;
+            stride *= m_dims[i];
+        }
+        if ( 1 == moved || ( diagonals && moved > 1 ) ) {
+            m_sendTo.push_back( rank );
+        }
+    }
+    m_recvFrom = m_sendTo;
+}
+
+void SyntheticGenerator::next( Convert& convert )
+{
+    int tag = m_iteration & 0xffff;
+
+    switch ( m_state ) {
+      case Init:
+        m_state = StartDelay;
+        convert.init();
+        break;
+
+      case StartDelay:
+        m_state = Compute;
+        if ( m_scatteredStart && m_startDelayMax >= 1 ) {
+            convert.compute( ns( m_rng() % (uint64_t) m_startDelayMax ) );
+        }
+        break;
+
+      case Compute:
+        peers( m_iteration );
+        m_pos = 0;
+        m_state = Post;
+        if ( m_computeDelay > 0 ) {
+            convert.compute( ns( m_computeDelay ) );
+        }
+        break;
+
+      case Post:
+        if ( m_pos < m_recvFrom.size() ) {
+            convert.irecv( m_recvFrom[m_pos], GroupWorld, tag, NULL, m_reqBytes, &m_handles[m_pos] );
+            ++m_pos;
+        } else if ( m_pos < m_handles.size() ) {
+            int peer = m_sendTo[ m_pos - m_recvFrom.size() ];
+            convert.isend( peer, GroupWorld, tag, m_reqVc, m_rspVc, NULL, m_reqBytes, m_rspBytes, &m_handles[m_pos], 0, 0 );
+            ++m_pos;
+        } else {
+            m_state = Wait;
+        }
+        break;
+
+      case Wait:
+        if ( m_testPoll && ! m_handles.empty() ) {
+            m_state = Poll;
+            convert.testall( m_handles.size(), m_handles.data(), &m_flag );
+            break;
+        }
+        m_state = ++m_iteration < m_iterations ? Compute : Exit;
+        if ( ! m_handles.empty() ) {
+            convert.waitall( m_handles.size(), m_handles.data() );
+        }
+        break;
+
+      case Poll:
+        if ( m_flag ) {
+            m_state = ++m_iteration < m_iterations ? Compute : Exit;
+        } else {
+            m_state = Wait;
+            if ( m_pollInterval >= 1 ) {
+                convert.compute( ns( m_pollInterval ) );
+            }
+        }
+        break;
+
+      case Exit:
+        m_state = Done;
+        convert.exit();
+        break;
+
+      case Done:
+        m_output.fatal(CALL_INFO,-1,"asked for a call after exit\n");
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_SYNTHETIC_H
+#define _SWM_SYNTHETIC_H
+
+#include <sst/core/output.h>
+
+#include <boost/property_tree/ptree.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "generator.h"
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Synthetic traffic patterns run as a state machine on the SST thread. Each iteration a
+// rank computes for compute_delay cycles, posts an Irecv for every rank that sends to it
+// and an Isend to every rank it sends to, and waits for all of them, or with test_poll
+// calls Testall until they are done, computing poll_interval cycles between tries. The
+// patterns read the same jobs.cfg keys as the skeletons, incast, many_to_many and
+// nearest_neighbor replace the skeletons when nativeWorkload is set, the others only
+// exist here.
+class SyntheticGenerator : public Generator {
+  public:
+    SyntheticGenerator( std::string name, boost::property_tree::ptree& root, int numRanks, int rank, double cpuFreq,
+            int jobId, uint32_t verboseLevel, uint32_t verboseMask );
+
+    void next( Convert& convert );
+
+    // true if name is run by this generator
+    static bool runs( std::string name, bool native );
+
+  private:
+    enum Pattern { Incast, ManyToMany, NearestNeighbor, UniformRandom, BitComplement, Transpose, Stencil3d } m_pattern;
+    enum State { Init, StartDelay, Compute, Post, Wait, Poll, Exit, Done } m_state;
+
+    void peers( int iteration );
+    void neighbors( bool diagonals );
+    std::vector<int> interval( boost::property_tree::ptree& root, const char* key, int lo, int hi );
+    double ns( double cycles ) { return cycles / m_cpuFreq; }
+
+    Output      m_output;
+    int         m_numRanks;
+    int         m_rank;
+    double      m_cpuFreq;
+
+    int         m_iterations;
+    double      m_computeDelay;
+    uint64_t    m_reqBytes;
+    uint64_t    m_rspBytes;
+    double      m_startDelayMax;
+    bool        m_scatteredStart;
+    bool        m_randomOrder;
+    bool        m_fixedPairs;
+    uint64_t    m_seed;
+    int         m_reqVc;
+    int         m_rspVc;
+    bool        m_testPoll;
+    double      m_pollInterval;
+    std::vector<int> m_src;
+    std::vector<int> m_dst;
+    std::vector<int> m_dims;
+
+    int         m_iteration;
+    std::vector<int> m_recvFrom;
+    std::vector<int> m_sendTo;
+    std::vector<uint32_t> m_handles;
+    size_t      m_pos;
+    int         m_flag;
+    std::mt19937_64 m_rng;
+};
+
+}
+}
+
+#endif
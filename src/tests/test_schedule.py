@@ -0,0 +1,69 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2021 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2021, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+import sst
+from sst.merlin.base import *
+from sst.merlin.endpoint import *
+from sst.merlin.interface import *
+from sst.merlin.topology import *
+
+from sst.sstSwm import *
+
+if __name__ == "__main__":
+
+    PlatformDefinition.setCurrentPlatform("firefly-defaults")
+
+    w=4
+    x=4
+    y=4
+    z=2
+    numNodes=w*x*y*z
+    print( "numNodes ", numNodes );
+
+    ### Setup the topology
+    topo = topoTorus()
+
+    topo.link_latency = "40ns"
+    topo.shape = str(w) + "x" + str(x) + "x" + str(y) + "x" + str(z)
+    topo.width = "1x1x1x1"
+    topo.local_ports = 1
+
+    # Set up the routers
+    router = hr_router()
+    router.link_bw = "4GB/s"
+    router.flit_size = "8B"
+    router.xbar_bw = "46GB/s"
+    router.input_latency = "50ns"
+    router.output_latency = "50ns"
+    router.input_buf_size = "14kB"
+    router.output_buf_size = "14kB"
+    #router.num_vns = 1
+    #router.xbar_arb = "merlin.xbar_arb_lru"
+
+    topo.router = router
+    topo.link_latency = "50ns"
+
+    ### set up the endpoint
+    networkif = ReorderLinkControl()
+    networkif.link_bw = "4GB/s"
+    networkif.input_buf_size = "14kB"
+    networkif.output_buf_size = "14kB"
+
+    schedule = SwmSchedule(networkif)
+    schedule.readSchedule("schedule.json")
+
+    system = System()
+    system.setTopology(topo)
+    schedule.allocate(system,numNodes)
+
+    system.build()
@@ -77,6 +77,18 @@ if __name__ == "__main__":
     #ep.workload.path="lammps/lammps_workload.json"
     ep.workload.verboseLevel=0
     ep.workload.verboseMask=-1
+    #ep.workload.timelinePath="incast/timeline"
+    #ep.mapping_file="incast/rank.map"
+    #ep.comm_matrix="incast/comm.txt"
+    #ep.mapping_report="rank.map"
+    #ep.partition_matrix="incast/comm.txt"
+    #ep.partition_report="partition.txt"
+    #ep.workload.detailedRanks="0-7"
+    # polls with Testall on the analytic ranks left out of detailedRanks
+    #ep.workload.name="uniform_random"
+    #ep.workload.path="synthetic/uniform_random_poll.json"
+    #ep.detailed_nodes=[0,1]
+    #ep.workload.histogramPath="incast/histogram"
     #ep.nic.verboseLevel = 1
     ep.nic.verboseMask = (1<<3) | (1<<4) | ( 1<<7) | (1<<8) | (1<<11)
     #ep.nic.verboseMask = -1 & ( ~(1<<6) | ~(1<<10) )
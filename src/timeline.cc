@@ -0,0 +1,193 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+#include <sst/core/simulation.h>
+
+#include <cstring>
+
+#include "report.h"
+#include "timeline.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+std::map<int,Timeline::Job> Timeline::m_jobs;
+std::deque<Timeline::Work> Timeline::m_queue;
+bool Timeline::m_writing = false;
+int Timeline::m_users = 0;
+std::thread Timeline::m_writer;
+std::mutex Timeline::m_mutex;
+std::condition_variable Timeline::m_cv;
+
+static const char* kindName[] = { "compute", "blocking", "post", "wait", "collective", "other" };
+
+Timeline::Timeline( int jobId, int rank, std::string path, std::string format, size_t bufferSize,
+        const char** opNames, int numOps, uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_jobId(jobId), m_rank(rank), m_path(path), m_format(format), m_bufferSize(bufferSize)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:Timeline::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    if ( 0 != m_format.compare("chrome") && 0 != m_format.compare("binary") ) {
+        m_output.fatal(CALL_INFO,-1,"unknown timelineFormat %s\n",m_format.c_str());
+    }
+    if ( 0 == m_bufferSize ) {
+        m_output.fatal(CALL_INFO,-1,"timelineBuffer must be greater than 0\n");
+    }
+    m_buffer.reserve( m_bufferSize );
+
+    std::lock_guard<std::mutex> lck(m_mutex);
+    Job& job = m_jobs[jobId];
+    if ( 0 == job.users++ ) {
+        std::string name = fileName("bin");
+        job.fp = fopen( name.c_str(), "wb" );
+        if ( NULL == job.fp ) {
+            m_output.fatal(CALL_INFO,-1,"could not open timeline file %s\n",name.c_str());
+        }
+        int32_t id = jobId;
+        int32_t num = numOps;
+        fwrite( "SWMTL001", 1, 8, job.fp );
+        fwrite( &id, sizeof(id), 1, job.fp );
+        fwrite( &num, sizeof(num), 1, job.fp );
+        for ( int i = 0; i < numOps; i++ ) {
+            uint8_t len = strlen( opNames[i] );
+            fwrite( &len, sizeof(len), 1, job.fp );
+            fwrite( opNames[i], 1, len, job.fp );
+        }
+    }
+    if ( 0 == m_users++ ) {
+        m_writer = std::thread( writer );
+    }
+}
+
+std::string Timeline::fileName( const char* suffix )
+{
+    return jobFileName( m_path, m_jobId ) + "." + suffix;
+}
+
+void Timeline::flush()
+{
+    m_output.debug(CALL_INFO, 2, SWM_TIMELINE_DBG_MASK,"%zu records\n",m_buffer.size());
+    {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        m_queue.push_back( Work() );
+        m_queue.back().fp = m_jobs[m_jobId].fp;
+        m_queue.back().records.swap( m_buffer );
+    }
+    m_cv.notify_all();
+    m_buffer.reserve( m_bufferSize );
+}
+
+// runs in its own thread until the last timeline in the process finishes
+void Timeline::writer()
+{
+    std::unique_lock<std::mutex> lck(m_mutex);
+    while ( true ) {
+        m_cv.wait( lck, []{ return ! m_queue.empty() || 0 == m_users; } );
+        if ( m_queue.empty() ) {
+            return;
+        }
+        Work work;
+        std::swap( work, m_queue.front() );
+        m_queue.pop_front();
+        m_writing = true;
+        lck.unlock();
+
+        fwrite( work.records.data(), sizeof(Record), work.records.size(), work.fp );
+
+        lck.lock();
+        m_writing = false;
+        m_cv.notify_all();
+    }
+}
+
+void Timeline::finish()
+{
+    if ( ! m_buffer.empty() ) {
+        flush();
+    }
+
+    std::unique_lock<std::mutex> lck(m_mutex);
+    Job& job = m_jobs[m_jobId];
+    if ( 0 == --job.users ) {
+        m_cv.wait( lck, []{ return m_queue.empty() && ! m_writing; } );
+        fclose( job.fp );
+        job.fp = NULL;
+        if ( 0 == m_format.compare("chrome") ) {
+            convert( fileName("bin") );
+        } else {
+            m_output.output("job %d: timeline written to %s\n",m_jobId,fileName("bin").c_str());
+        }
+    }
+    if ( 0 == --m_users ) {
+        lck.unlock();
+        m_cv.notify_all();
+        m_writer.join();
+    }
+}
+
+// The binary file is "SWMTL001", int32 jobId, int32 numOps, the op names each as a
+// uint8 length followed by the characters, then Records in the order they were flushed.
+// Records of different ranks are interleaved and each rank's are in time order.
+void Timeline::convert( std::string binName )
+{
+    FILE* in = fopen( binName.c_str(), "rb" );
+    std::string jsonName = fileName("json");
+    FILE* out = fopen( jsonName.c_str(), "w" );
+    if ( NULL == in || NULL == out ) {
+        m_output.fatal(CALL_INFO,-1,"could not convert timeline file %s to %s\n",binName.c_str(),jsonName.c_str());
+    }
+
+    char magic[8];
+    int32_t jobId, numOps;
+    if ( 1 != fread( magic, sizeof(magic), 1, in ) || 1 != fread( &jobId, sizeof(jobId), 1, in ) ||
+            1 != fread( &numOps, sizeof(numOps), 1, in ) ) {
+        m_output.fatal(CALL_INFO,-1,"bad timeline file %s\n",binName.c_str());
+    }
+    std::vector<std::string> opNames( numOps );
+    for ( auto& name : opNames ) {
+        uint8_t len;
+        char buf[256];
+        if ( 1 != fread( &len, sizeof(len), 1, in ) || len != fread( buf, 1, len, in ) ) {
+            m_output.fatal(CALL_INFO,-1,"bad timeline file %s\n",binName.c_str());
+        }
+        name.assign( buf, len );
+    }
+
+    fprintf( out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+    fprintf( out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"job %d\"}}", jobId, jobId );
+
+    uint64_t count = 0;
+    std::vector<Record> records( 4096, Record( 0, Other, 0, 0, 0, 0, 0 ) );
+    size_t num;
+    while ( ( num = fread( records.data(), sizeof(Record), records.size(), in ) ) ) {
+        for ( size_t i = 0; i < num; i++ ) {
+            Record& r = records[i];
+            fprintf( out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                    "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"peer\":%d,\"bytes\":%" PRIu64 "}}",
+                    r.op < opNames.size() ? opNames[r.op].c_str() : "unknown", kindName[r.kind], jobId, r.rank,
+                    r.start / 1000.0, ( r.end - r.start ) / 1000.0, r.peer, r.bytes );
+        }
+        count += num;
+    }
+    fprintf( out, "\n]}\n" );
+    fclose( in );
+    fclose( out );
+    remove( binName.c_str() );
+
+    m_output.output("job %d: timeline with %" PRIu64 " intervals written to %s\n",m_jobId,count,jsonName.c_str());
+}
@@ -0,0 +1,105 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_TIMELINE_H
+#define _SWM_TIMELINE_H
+
+#include <sst/core/output.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Per rank record of what a rank spent simulated time on, one interval per call the
+// workload made. Records are buffered per rank and handed to a writer thread shared by
+// all ranks in the process, which appends them to one binary file per job. When the
+// last rank of a job in the process finishes the file is converted to Chrome trace JSON
+// unless the binary format was asked for, see write() for the layout.
+class Timeline {
+  public:
+    enum Kind { Compute = 0, Blocking = 1, Post = 2, Wait = 3, Collective = 4, Other = 5 };
+
+    Timeline( int jobId, int rank, std::string path, std::string format, size_t bufferSize,
+            const char** opNames, int numOps, uint32_t verboseLevel, uint32_t verboseMask );
+
+    void record( int op, Kind kind, SimTime_t start, SimTime_t end, int peer, uint64_t bytes ) {
+        m_buffer.push_back( Record( op, kind, start, end, m_rank, peer, bytes ) );
+        if ( m_buffer.size() == m_bufferSize ) {
+            flush();
+        }
+    }
+
+    void finish();
+
+  private:
+    struct Record {
+        Record( int op, Kind kind, SimTime_t start, SimTime_t end, int rank, int peer, uint64_t bytes ) :
+            start(start), end(end), bytes(bytes), rank(rank), peer(peer), op(op), kind(kind) {}
+        uint64_t start;
+        uint64_t end;
+        uint64_t bytes;
+        int32_t  rank;
+        int32_t  peer;
+        uint16_t op;
+        uint16_t kind;
+        uint32_t pad = 0;
+    };
+
+    void flush();
+    void convert( std::string binName );
+    std::string fileName( const char* suffix );
+
+    Output      m_output;
+    int         m_jobId;
+    int         m_rank;
+    std::string m_path;
+    std::string m_format;
+    size_t      m_bufferSize;
+    std::vector<Record> m_buffer;
+
+    struct Job {
+        Job() : users(0), fp(NULL) {}
+        int users;
+        FILE* fp;
+    };
+    static std::map<int,Job> m_jobs;
+
+    // buffers waiting for the writer thread
+    struct Work {
+        FILE* fp;
+        std::vector<Record> records;
+    };
+    static void writer();
+    static std::deque<Work> m_queue;
+    static bool m_writing;
+    static int m_users;
+    static std::thread m_writer;
+    static std::mutex m_mutex;
+    static std::condition_variable m_cv;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,366 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include "sst/core/sst_config.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cstring>
+
+#include "convert.h"
+#include "trace.h"
+
+using namespace SST;
+using namespace SST::Swm;
+
+static const std::map<std::string,int> datatypeSize = {
+    { "MPI_CHAR", 1 }, { "MPI_SIGNED_CHAR", 1 }, { "MPI_UNSIGNED_CHAR", 1 }, { "MPI_BYTE", 1 }, { "MPI_PACKED", 1 },
+    { "MPI_SHORT", 2 }, { "MPI_UNSIGNED_SHORT", 2 },
+    { "MPI_INT", 4 }, { "MPI_UNSIGNED", 4 }, { "MPI_FLOAT", 4 }, { "MPI_INTEGER", 4 }, { "MPI_REAL", 4 },
+    { "MPI_LONG", 8 }, { "MPI_UNSIGNED_LONG", 8 }, { "MPI_LONG_LONG", 8 }, { "MPI_LONG_LONG_INT", 8 },
+    { "MPI_UNSIGNED_LONG_LONG", 8 }, { "MPI_DOUBLE", 8 }, { "MPI_DOUBLE_PRECISION", 8 }, { "MPI_COMPLEX", 8 },
+    { "MPI_2INT", 8 }, { "MPI_FLOAT_INT", 8 }, { "MPI_LONG_DOUBLE", 16 }, { "MPI_DOUBLE_COMPLEX", 16 },
+    { "MPI_DOUBLE_INT", 12 }, { "MPI_LONG_INT", 12 },
+};
+
+TraceGenerator::TraceGenerator( std::string fileName, double computeScale, int jobId, int rank,
+        uint32_t verboseLevel, uint32_t verboseMask ) :
+    m_fileName(fileName), m_computeScale(computeScale), m_computeDone(false), m_lastLeave(-1),
+    m_pendingReq(-1), m_pendingComm(-1), m_collWait(false), m_exited(false)
+{
+    char buffer[100];
+    snprintf(buffer,100,"@t:%d:%d:TraceGenerator::@p():@l ",jobId,rank);
+    m_output.init(buffer, verboseLevel, verboseMask, Output::STDOUT);
+
+    int fd = open( fileName.c_str(), O_RDONLY );
+    if ( fd < 0 ) {
+        m_output.fatal(CALL_INFO,-1,"could not open trace %s\n",fileName.c_str());
+    }
+    struct stat st;
+    fstat( fd, &st );
+    m_size = st.st_size;
+    m_base = NULL;
+    if ( m_size ) {
+        void* addr = mmap( NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( MAP_FAILED == addr ) {
+            m_output.fatal(CALL_INFO,-1,"could not map trace %s\n",fileName.c_str());
+        }
+        madvise( addr, m_size, MADV_SEQUENTIAL );
+        m_base = (const char*) addr;
+    }
+    close( fd );
+    m_pos = m_base;
+    m_end = m_base + m_size;
+
+    m_call.name.clear();
+}
+
+TraceGenerator::~TraceGenerator()
+{
+    if ( m_base ) {
+        munmap( (void*) m_base, m_size );
+    }
+}
+
+bool TraceGenerator::readLine( const char*& line, size_t& len )
+{
+    if ( m_pos >= m_end ) {
+        return false;
+    }
+    line = m_pos;
+    const char* nl = (const char*) memchr( m_pos, '\n', m_end - m_pos );
+    len = ( nl ? nl : m_end ) - m_pos;
+    m_pos = nl ? nl + 1 : m_end;
+    return true;
+}
+
+// A call is "<name> entering at walltime <t>, ...", one "<type> <arg>=<value>" line per
+// argument and "<name> returning at walltime <t>, ...".
+bool TraceGenerator::readCall( Call& call )
+{
+    const char* line;
+    size_t len;
+    static const char* entering = " entering at walltime ";
+    static const char* returning = " returning at walltime ";
+
+    call.name.clear();
+    call.args.clear();
+    while ( readLine( line, len ) ) {
+        std::string str( line, len );
+        if ( call.name.empty() ) {
+            size_t pos = str.find( entering );
+            if ( pos != std::string::npos ) {
+                call.name = str.substr( 0, pos );
+                call.enter = atof( str.c_str() + pos + strlen( entering ) );
+            }
+            continue;
+        }
+        if ( 0 == str.compare( 0, call.name.size(), call.name ) && str.find( returning ) == call.name.size() ) {
+            call.leave = atof( str.c_str() + call.name.size() + strlen( returning ) );
+            return true;
+        }
+        size_t eq = str.find( '=' );
+        if ( eq == std::string::npos ) {
+            continue;
+        }
+        size_t start = str.rfind( ' ', eq );
+        start = start == std::string::npos ? 0 : start + 1;
+        std::string name = str.substr( start, eq - start );
+        size_t bracket = name.find( '[' );
+        if ( bracket != std::string::npos ) {
+            name.resize( bracket );
+        }
+        call.args[name] = str.substr( eq + 1 );
+    }
+    if ( ! call.name.empty() ) {
+        m_output.output("trace %s ends inside %s\n",m_fileName.c_str(),call.name.c_str());
+    }
+    return false;
+}
+
+long TraceGenerator::intArg( Call& call, const char* name )
+{
+    auto iter = call.args.find( name );
+    if ( iter == call.args.end() ) {
+        m_output.fatal(CALL_INFO,-1,"%s in trace %s has no argument %s\n",call.name.c_str(),m_fileName.c_str(),name);
+    }
+    // output handles are printed in brackets
+    const char* ptr = iter->second.c_str();
+    while ( *ptr && *ptr != '-' && ! isdigit( *ptr ) ) {
+        ++ptr;
+    }
+    return atol( ptr );
+}
+
+std::vector<long> TraceGenerator::arrayArg( Call& call, const char* name )
+{
+    std::vector<long> values;
+    auto iter = call.args.find( name );
+    if ( iter == call.args.end() ) {
+        return values;
+    }
+    const char* ptr = iter->second.c_str();
+    while ( *ptr && *ptr != ']' ) {
+        if ( *ptr == '-' || isdigit( *ptr ) ) {
+            char* end;
+            values.push_back( strtol( ptr, &end, 10 ) );
+            ptr = end;
+        } else {
+            ++ptr;
+        }
+    }
+    return values;
+}
+
+uint64_t TraceGenerator::bytesArg( Call& call, const char* count, const char* datatype )
+{
+    std::string& value = call.args[datatype];
+    size_t open = value.find( '(' );
+    size_t close = value.find( ')' );
+    int size = 1;
+    if ( open != std::string::npos && close != std::string::npos ) {
+        auto iter = datatypeSize.find( value.substr( open + 1, close - open - 1 ) );
+        if ( iter != datatypeSize.end() ) {
+            size = iter->second;
+        }
+    }
+    return intArg( call, count ) * size;
+}
+
+// MPI_COMM_WORLD or a communicator the trace created with MPI_Comm_split or MPI_Comm_dup
+int TraceGenerator::commArg( Call& call, const char* name )
+{
+    std::string& value = call.args[name];
+    if ( value.find( "MPI_COMM_WORLD" ) != std::string::npos ) {
+        return GroupWorld;
+    }
+    auto iter = m_comms.find( intArg( call, name ) );
+    if ( iter == m_comms.end() ) {
+        m_output.fatal(CALL_INFO,-1,"%s in trace %s uses communicator %s that was not created by a replayed call\n",
+                call.name.c_str(),m_fileName.c_str(),value.c_str());
+    }
+    return iter->second;
+}
+
+// puts the handles of the trace requests that are known in m_reqIds, each is removed because
+// the call it is used in completes it, returns how many there are
+size_t TraceGenerator::handles( std::vector<long> reqs )
+{
+    m_reqIds.clear();
+    for ( auto req : reqs ) {
+        auto iter = m_handles.find( req );
+        if ( iter != m_handles.end() ) {
+            m_reqIds.push_back( iter->second );
+            m_handles.erase( iter );
+        }
+    }
+    return m_reqIds.size();
+}
+
+// calls that only look at or set up local state take no simulated time and are skipped
+bool TraceGenerator::local( const std::string& name )
+{
+    static const char* prefixes[] = { "MPI_Type_", "MPI_Group_", "MPI_Op_", "MPI_Errhandler_", "MPI_Info_",
+        "MPI_Attr_", "MPI_Keyval_", "MPI_Comm_get_", "MPI_Comm_set_" };
+    static const char* names[] = { "MPI_Wtime", "MPI_Wtick", "MPI_Initialized", "MPI_Finalized", "MPI_Comm_group",
+        "MPI_Comm_compare", "MPI_Comm_test_inter", "MPI_Pcontrol", "MPI_Address", "MPI_Get_count",
+        "MPI_Get_elements", "MPI_Get_processor_name", "MPI_Get_version", "MPI_Request_free" };
+    for ( auto prefix : prefixes ) {
+        if ( 0 == name.compare( 0, strlen( prefix ), prefix ) ) {
+            return true;
+        }
+    }
+    for ( auto local : names ) {
+        if ( name == local ) {
+            return true;
+        }
+    }
+    return name.compare( 0, 4, "MPI_" ) == 0 && ( name.find( "_rank" ) != std::string::npos ||
+            name.find( "_size" ) != std::string::npos );
+}
+
+void TraceGenerator::next( Convert& convert )
+{
+    if ( -1 != m_pendingReq ) {
+        m_handles[m_pendingReq] = m_handle;
+        m_pendingReq = -1;
+    }
+    if ( -1 != m_pendingComm ) {
+        if ( SWM_COMM_NULL != m_newComm ) {
+            m_comms[m_pendingComm] = m_newComm;
+        }
+        m_pendingComm = -1;
+    }
+    if ( m_collWait ) {
+        m_collWait = false;
+        convert.wait( m_handle );
+        return;
+    }
+
+    if ( m_call.name.empty() ) {
+        if ( m_exited ) {
+            m_output.fatal(CALL_INFO,-1,"trace %s was asked for a call after exit\n",m_fileName.c_str());
+        }
+        if ( ! readCall( m_call ) ) {
+            m_exited = true;
+            convert.exit();
+            return;
+        }
+        m_computeDone = false;
+    }
+
+    if ( ! m_computeDone ) {
+        m_computeDone = true;
+        double ns = m_lastLeave < 0 ? 0 : ( m_call.enter - m_lastLeave ) * 1e9 * m_computeScale;
+        if ( ns >= 1 ) {
+            convert.compute( ns );
+            return;
+        }
+    }
+
+    m_lastLeave = m_call.leave;
+    replay( convert, m_call );
+    m_call.name.clear();
+}
+
+// Completions are replayed as the trace recorded them, a Waitany waits on the request
+// the traced run got, a Test that succeeded waits for the request and one that failed
+// is not replayed. An Alltoall is an Ialltoall followed by a wait, a call that
+// communicates and has no replay stops the run.
+void TraceGenerator::replay( Convert& convert, Call& call )
+{
+    m_output.debug(CALL_INFO, 2, SWM_TRACE_DBG_MASK,"%s\n",call.name.c_str());
+    const std::string& name = call.name;
+
+    if ( name == "MPI_Init" || name == "MPI_Init_thread" ) {
+        convert.init();
+    } else if ( name == "MPI_Finalize" ) {
+        convert.finalize();
+    } else if ( name == "MPI_Send" || name == "MPI_Ssend" || name == "MPI_Rsend" || name == "MPI_Bsend" ) {
+        convert.send( intArg( call, "dest" ), commArg( call ), intArg( call, "tag" ), 0, 0, NULL, bytesArg( call ), 0, 0, 0 );
+    } else if ( name == "MPI_Isend" || name == "MPI_Issend" || name == "MPI_Irsend" || name == "MPI_Ibsend" ) {
+        m_pendingReq = intArg( call, "request" );
+        convert.isend( intArg( call, "dest" ), commArg( call ), intArg( call, "tag" ), 0, 0, NULL, bytesArg( call ), 0, &m_handle, 0, 0 );
+    } else if ( name == "MPI_Recv" ) {
+        convert.recv( intArg( call, "source" ), commArg( call ), intArg( call, "tag" ), NULL, bytesArg( call ) );
+    } else if ( name == "MPI_Irecv" ) {
+        m_pendingReq = intArg( call, "request" );
+        convert.irecv( intArg( call, "source" ), commArg( call ), intArg( call, "tag" ), NULL, bytesArg( call ), &m_handle );
+    } else if ( name == "MPI_Sendrecv" ) {
+        convert.sendrecv( commArg( call ), intArg( call, "dest" ), intArg( call, "sendtag" ), 0, 0, NULL,
+                bytesArg( call, "sendcount", "sendtype" ), 0, intArg( call, "source" ), intArg( call, "recvtag" ), NULL, 0, 0 );
+    } else if ( name == "MPI_Wait" ) {
+        if ( handles( { intArg( call, "request" ) } ) ) {
+            convert.wait( m_reqIds[0] );
+        }
+    } else if ( name == "MPI_Waitall" ) {
+        if ( handles( arrayArg( call, "requests" ) ) ) {
+            convert.waitall( m_reqIds.size(), m_reqIds.data() );
+        }
+    } else if ( name == "MPI_Waitany" || name == "MPI_Testany" ) {
+        std::vector<long> reqs = arrayArg( call, "requests" );
+        long index = intArg( call, "index" );
+        bool done = name == "MPI_Waitany" || intArg( call, "flag" );
+        if ( done && index >= 0 && index < (long) reqs.size() && handles( { reqs[index] } ) ) {
+            convert.wait( m_reqIds[0] );
+        }
+    } else if ( name == "MPI_Waitsome" || name == "MPI_Testsome" ) {
+        std::vector<long> reqs = arrayArg( call, "requests" );
+        std::vector<long> done;
+        for ( auto index : arrayArg( call, "indices" ) ) {
+            if ( index >= 0 && index < (long) reqs.size() ) {
+                done.push_back( reqs[index] );
+            }
+        }
+        if ( handles( done ) ) {
+            convert.waitall( m_reqIds.size(), m_reqIds.data() );
+        }
+    } else if ( name == "MPI_Test" ) {
+        if ( intArg( call, "flag" ) && handles( { intArg( call, "request" ) } ) ) {
+            convert.wait( m_reqIds[0] );
+        }
+    } else if ( name == "MPI_Testall" ) {
+        if ( intArg( call, "flag" ) && handles( arrayArg( call, "requests" ) ) ) {
+            convert.waitall( m_reqIds.size(), m_reqIds.data() );
+        }
+    } else if ( name == "MPI_Comm_split" ) {
+        // MPI_UNDEFINED is negative in every MPI, a color of -1 gives no communicator
+        int color = intArg( call, "color" );
+        m_pendingComm = intArg( call, "newcomm" );
+        convert.commSplit( commArg( call, "oldcomm" ), color < 0 ? -1 : color, intArg( call, "key" ), &m_newComm );
+    } else if ( name == "MPI_Comm_dup" ) {
+        m_pendingComm = intArg( call, "newcomm" );
+        convert.commDup( commArg( call, "oldcomm" ), &m_newComm );
+    } else if ( name == "MPI_Comm_free" ) {
+        // the handle is written back as MPI_COMM_NULL, the one freed is the one going in
+        int comm = commArg( call );
+        m_comms.erase( intArg( call, "comm" ) );
+        convert.commFree( comm );
+    } else if ( name == "MPI_Barrier" ) {
+        convert.barrier( commArg( call ), 0, 0, NULL, 0, 0, 0, 0 );
+    } else if ( name == "MPI_Allreduce" || name == "MPI_Reduce" || name == "MPI_Bcast" ) {
+        // reductions and broadcasts are replayed as an allreduce of the same size
+        convert.allreduce( bytesArg( call ), 0, commArg( call ), 0, 0, NULL, NULL, 0, 0, 0, 0 );
+    } else if ( name == "MPI_Alltoall" ) {
+        m_collWait = true;
+        convert.ialltoall( bytesArg( call, "sendcount", "sendtype" ), commArg( call ), &m_handle );
+    } else if ( ! local( name ) ) {
+        m_output.fatal(CALL_INFO,-1,"trace %s: %s can't be replayed\n",m_fileName.c_str(),name.c_str());
+    }
+}
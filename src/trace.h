@@ -0,0 +1,95 @@
+// Copyright 2009-2021 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2021, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _SWM_TRACE_H
+#define _SWM_TRACE_H
+
+#include <sst/core/output.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "generator.h"
+#include "dbg.h"
+
+namespace SST {
+namespace Swm {
+
+// Replays a rank's DUMPI trace, as printed by dumpi2ascii, one MPI call at a time. The
+// file is memory mapped and parsed as it is consumed so traces of any length stream
+// through a fixed amount of memory. The time between one call returning and the next
+// one entering is replayed as compute, scaled by compute_scale.
+class TraceGenerator : public Generator {
+  public:
+    TraceGenerator( std::string fileName, double computeScale, int jobId, int rank,
+            uint32_t verboseLevel, uint32_t verboseMask );
+    ~TraceGenerator();
+
+    void next( Convert& convert );
+
+  private:
+    struct Call {
+        std::string name;
+        double enter;
+        double leave;
+        std::map<std::string,std::string> args;
+    };
+
+    bool readCall( Call& call );
+    bool readLine( const char*& line, size_t& len );
+    void replay( Convert& convert, Call& call );
+
+    long intArg( Call& call, const char* name );
+    std::vector<long> arrayArg( Call& call, const char* name );
+    uint64_t bytesArg( Call& call, const char* count = "count", const char* datatype = "datatype" );
+    int commArg( Call& call, const char* name = "comm" );
+    size_t handles( std::vector<long> reqs );
+    static bool local( const std::string& name );
+
+    Output      m_output;
+    std::string m_fileName;
+    double      m_computeScale;
+    const char* m_base;
+    const char* m_pos;
+    const char* m_end;
+    size_t      m_size;
+
+    Call        m_call;
+    bool        m_computeDone;
+    double      m_lastLeave;
+
+    // trace request ids to the handles Convert gave them, the handle of the last
+    // Isend or Irecv is written to m_handle and entered on the next call
+    std::map<long,uint32_t> m_handles;
+    long        m_pendingReq;
+    uint32_t    m_handle;
+    std::vector<uint32_t> m_reqIds;
+
+    // trace communicator handles to SWM comm ids, the one a split or dup creates is
+    // written to m_newComm and entered on the next call like a request handle
+    std::map<long,int> m_comms;
+    long        m_pendingComm;
+    int         m_newComm;
+
+    // the blocking collective replayed as a request is waited for on the next call
+    bool        m_collWait;
+    bool        m_exited;
+};
+
+}
+}
+
+#endif
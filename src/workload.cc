@@ -24,18 +24,20 @@
 
 #include <boost/property_tree/json_parser.hpp>
 #include <swm-include.h>
+#include "swmext.h"
 #include "workload.h"
 
 using namespace SST;
 using namespace SST::Swm;
 
-std::map<int,boost::property_tree::ptree> Workload::m_root;
+std::map<Workload::ConfigKey,boost::property_tree::ptree> Workload::m_root;
 
-std::map<int,std::mutex> Workload::m_mutex;
-std::map<int,bool> Workload::m_readConfig;
+std::map<Workload::ConfigKey,std::mutex> Workload::m_mutex;
+std::map<Workload::ConfigKey,bool> Workload::m_readConfig;
 
-Workload::Workload( Convert* convert, std::string path, std::string name, int numRanks, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask) :
-	m_convert(convert), m_numRanks(numRanks), m_jobId(jobId), m_rank(rank), m_dbgLvl(verboseLevel), m_dbgMask(verboseMask)
+Workload::Workload( Convert* convert, Affinity* affinity, std::string path, std::string name, bool native,
+        const std::map<std::string,std::string>& cfg, int numRanks, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask) :
+	m_generator(NULL), m_convert(convert), m_affinity(affinity), m_jobId(jobId), m_rank(rank), m_numRanks(numRanks), m_dbgLvl(verboseLevel), m_dbgMask(verboseMask)
 {
     char buffer[100];
     snprintf(buffer,100,"@t:%d:Workload::@p():@l ",m_rank);
@@ -46,36 +48,57 @@ Workload::Workload( Convert* convert, std::string path, std::string name, int nu
     generic_ptrs = (void**)calloc(array_len,  sizeof(void*));
     generic_ptrs[0] = (void*)&rank;
 
-	if ( m_readConfig.find(jobId) == m_readConfig.end() ) {
-		m_readConfig[jobId] = true;
-		m_root[jobId];
-		m_mutex[jobId];
+	ConfigKey config( jobId, path );
+	if ( m_readConfig.find(config) == m_readConfig.end() ) {
+		m_readConfig[config] = true;
+		m_root[config];
+		m_mutex[config];
 	}
 
 	m_output.debug( CALL_INFO, 1, SWM_WORKLOAD_DBG_BITS, "path=%s workload=%s\n",path.c_str(),name.c_str());
 
-	boost::property_tree::ptree& root = m_root[jobId];
+	boost::property_tree::ptree& root = m_root[config];
 
-	std::unique_lock<std::mutex> lck(m_mutex[jobId]);
-	if ( m_readConfig[jobId] ) {
+	std::unique_lock<std::mutex> lck(m_mutex[config]);
+	if ( m_readConfig[config] ) {
     	try {
             std::ifstream jsonFile(path.c_str());
             boost::property_tree::json_parser::read_json(jsonFile, root);
             jsonFile.close();
 
             root.put("jobs.size", m_numRanks);
+            for ( auto& iter : cfg ) {
+                m_output.debug( CALL_INFO, 1, SWM_WORKLOAD_DBG_BITS, "jobs.cfg.%s=%s\n",iter.first.c_str(),iter.second.c_str());
+                root.put("jobs.cfg." + iter.first, iter.second);
+            }
     	}
     	catch(std::exception & e)
     	{
 			throw;
     	}
-        m_readConfig[jobId] = false;
+        m_readConfig[config] = false;
 	}
     lck.unlock();
 
+    if ( name.compare( "trace" ) == 0 )
+    {
+        // jobs.cfg.trace_prefix is the path of the dumpi2ascii output of each rank without "-NNNN.txt"
+        m_type = Trace;
+        char suffix[32];
+        snprintf( suffix, sizeof(suffix), "-%04d.txt", rank );
+        m_generator = new TraceGenerator( root.get<std::string>("jobs.cfg.trace_prefix") + suffix,
+                root.get<double>("jobs.cfg.compute_scale", 1.0), jobId, rank, verboseLevel, verboseMask );
+        return;
+    }
+
     m_cpuFreq = root.get<double>("jobs.cfg.cpu_freq") / 1e9;
 
-    if( name.compare( "lammps") == 0)
+    if ( SyntheticGenerator::runs( name, native ) )
+    {
+        m_type = Synthetic;
+        m_generator = new SyntheticGenerator( name, root, m_numRanks, rank, m_cpuFreq, jobId, verboseLevel, verboseMask );
+    }
+    else if( name.compare( "lammps") == 0)
     {
         m_type = Lammps;
         m_lammps = new LAMMPS_SWM(root, generic_ptrs);
@@ -124,15 +147,45 @@ static void workloadThread( Workload* workload ) {
 }
 
 void Workload::start() { 
+    m_convert->setGenerator( m_generator );
+    if ( m_generator ) {
+        m_output.debug( CALL_INFO, 1, SWM_WORKLOAD_DBG_BITS, "start without a thread\n");
+        m_convert->nextWork();
+        m_convert->doWork();
+        return;
+    }
 	m_output.debug( CALL_INFO, 1, SWM_WORKLOAD_DBG_BITS, "start thread\n");
 	m_thread = std::thread( workloadThread, this ); 
+    if ( m_affinity ) {
+        m_affinity->pin( m_thread );
+    }
     m_convert->waitForWork();
     m_convert->doWork();
 }
 
+// the stage returned, a chained workload starts the next one on the same ranks
+void Workload::join() { 
+    if ( m_generator ) {
+        delete m_generator;
+        m_generator = NULL;
+        return;
+    }
+	m_output.debug( CALL_INFO, 1, SWM_WORKLOAD_DBG_BITS, "join thread\n");
+    if ( m_thread.joinable() ) {
+	    m_thread.join(); 
+    }
+}
+
 void Workload::stop() { 
+    if ( m_generator ) {
+        join();
+        return;
+    }
 	m_output.debug( CALL_INFO, 1, SWM_WORKLOAD_DBG_BITS, "stop thread\n");
-	m_thread.join(); 
+    join();
+    if ( m_affinity ) {
+        m_affinity->finish();
+    }
 }
 
 void SWM_Init() 
@@ -226,6 +279,130 @@ void SWM_Waitall(int len, uint32_t * req_ids)
 	tl_workload->convert().waitall( len, req_ids );
 }
 
+void SWM_Test(uint32_t req_id, int* flag)
+{
+	WorkloadDBG(tl_workload, "req_id=%d\n",req_id);
+	tl_workload->convert().test( req_id, flag );
+}
+
+void SWM_Testall(int len, uint32_t * req_ids, int* flag)
+{
+	WorkloadDBG(tl_workload, "len=%d\n",len);
+	tl_workload->convert().testall( len, req_ids, flag );
+}
+
+void SWM_Waitany(int len, uint32_t * req_ids, int* index)
+{
+	WorkloadDBG(tl_workload, "len=%d\n",len);
+	tl_workload->convert().waitany( len, req_ids, index );
+}
+
+void SWM_Waitsome(int len, uint32_t * req_ids, int* outcount, int* indices)
+{
+	WorkloadDBG(tl_workload, "len=%d\n",len);
+	tl_workload->convert().waitsome( len, req_ids, outcount, indices );
+}
+
+void SWM_Mark_Iteration(SWM_TAG iter_tag)
+{
+	WorkloadDBG(tl_workload, "iter_tag=%d\n",iter_tag);
+	tl_workload->convert().markIteration( iter_tag );
+}
+
+void SWM_Mark(int phase_id)
+{
+	WorkloadDBG(tl_workload, "phase_id=%d\n",phase_id);
+	tl_workload->convert().mark( phase_id );
+}
+
+void SWM_Comm_split(SWM_COMM_ID comm_id, int color, int key, SWM_COMM_ID* newcomm)
+{
+	WorkloadDBG(tl_workload, "comm_id=%d color=%d key=%d\n",comm_id,color,key);
+	tl_workload->convert().commSplit( comm_id, color, key, newcomm );
+}
+
+void SWM_Comm_dup(SWM_COMM_ID comm_id, SWM_COMM_ID* newcomm)
+{
+	WorkloadDBG(tl_workload, "comm_id=%d\n",comm_id);
+	tl_workload->convert().commDup( comm_id, newcomm );
+}
+
+void SWM_Cart_sub(SWM_COMM_ID comm_id, int ndims, const int* dims, const int* remain_dims, SWM_COMM_ID* newcomm)
+{
+	WorkloadDBG(tl_workload, "comm_id=%d ndims=%d\n",comm_id,ndims);
+	tl_workload->convert().cartSub( comm_id, ndims, dims, remain_dims, newcomm );
+}
+
+void SWM_Comm_free(SWM_COMM_ID comm_id)
+{
+	WorkloadDBG(tl_workload, "comm_id=%d\n",comm_id);
+	tl_workload->convert().commFree( comm_id );
+}
+
+void SWM_Put(SWM_PEER pe, SWM_BYTES bytes)
+{
+	WorkloadDBG(tl_workload, "pe=%d bytes=%d\n",pe,bytes);
+	tl_workload->convert().put( pe, bytes, NULL );
+}
+
+void SWM_Get(SWM_PEER pe, SWM_BYTES bytes)
+{
+	WorkloadDBG(tl_workload, "pe=%d bytes=%d\n",pe,bytes);
+	tl_workload->convert().get( pe, bytes, NULL );
+}
+
+void SWM_Put_nb(SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle)
+{
+	WorkloadDBG(tl_workload, "pe=%d bytes=%d\n",pe,bytes);
+	tl_workload->convert().put( pe, bytes, handle );
+}
+
+void SWM_Get_nb(SWM_PEER pe, SWM_BYTES bytes, uint32_t* handle)
+{
+	WorkloadDBG(tl_workload, "pe=%d bytes=%d\n",pe,bytes);
+	tl_workload->convert().get( pe, bytes, handle );
+}
+
+void SWM_Fetch_add(SWM_PEER pe, long value, long* result)
+{
+	WorkloadDBG(tl_workload, "pe=%d value=%ld\n",pe,value);
+	tl_workload->convert().fetchAdd( pe, value, result );
+}
+
+void SWM_Fence()
+{
+	WorkloadDBG(tl_workload, "\n");
+	tl_workload->convert().fence();
+}
+
+void SWM_Iallreduce(SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle)
+{
+	WorkloadDBG(tl_workload, "bytes=%d comm_id=%d\n",bytes,comm_id);
+	tl_workload->convert().iallreduce( bytes, comm_id, handle );
+}
+
+void SWM_Ibarrier(SWM_COMM_ID comm_id, uint32_t* handle)
+{
+	WorkloadDBG(tl_workload, "comm_id=%d\n",comm_id);
+	tl_workload->convert().ibarrier( comm_id, handle );
+}
+
+void SWM_Ialltoall(SWM_BYTES bytes, SWM_COMM_ID comm_id, uint32_t* handle)
+{
+	WorkloadDBG(tl_workload, "bytes=%d comm_id=%d\n",bytes,comm_id);
+	tl_workload->convert().ialltoall( bytes, comm_id, handle );
+}
+
+int SWM_Comm_rank(SWM_COMM_ID comm_id)
+{
+	return tl_workload->convert().commRank( comm_id );
+}
+
+int SWM_Comm_size(SWM_COMM_ID comm_id)
+{
+	return tl_workload->convert().commSize( comm_id );
+}
+
 void SWM_Sendrecv(
          SWM_COMM_ID comm_id,
          SWM_PEER sendpeer,
@@ -25,7 +25,10 @@
 #include "many_to_many_swm_user_code.h"
 #include "milc_swm_user_code.h"
 
+#include "affinity.h"
 #include "convert.h"
+#include "synthetic.h"
+#include "trace.h"
 #include "dbg.h"
 
 #if 1
@@ -46,9 +49,12 @@ namespace Swm {
 class Workload {
 
   public:
-    Workload( Convert* convert, std::string path, std::string name, int numRanks, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask );
-    enum { Lammps,Nekbone,NN,MM,MILC,Incast } m_type;
+    // cfg holds values that replace the ones under jobs.cfg in the file
+    Workload( Convert* convert, Affinity* affinity, std::string path, std::string name, bool native,
+            const std::map<std::string,std::string>& cfg, int numRanks, int jobId, int rank, uint32_t verboseLevel, uint32_t verboseMask );
+    enum { Lammps,Nekbone,NN,MM,MILC,Incast,Trace,Synthetic } m_type;
 	void start();
+	void join();
 	void stop();
     void call() {
         switch ( m_type ) {
@@ -82,9 +88,11 @@ class Workload {
     NearestNeighborSWMUserCode* m_nn;
 	ManyToManySWMUserCode*      m_mm;
 	MilcSWMUserCode*			m_milc;
+	Generator*                  m_generator;
 
 	std::thread m_thread;
 	Convert*    m_convert;
+	Affinity*   m_affinity;
     Output      m_output;
 	int			m_jobId;
 	int         m_rank;
@@ -92,9 +100,11 @@ class Workload {
     double      m_cpuFreq;
     int         m_dbgLvl;
     int         m_dbgMask;
-    static std::map<int,std::mutex>  m_mutex;
-    static std::map<int,bool>        m_readConfig;
-    static std::map<int,boost::property_tree::ptree> m_root;
+    // the stages of a chained workload can read different files
+    typedef std::pair<int,std::string> ConfigKey;
+    static std::map<ConfigKey,std::mutex>  m_mutex;
+    static std::map<ConfigKey,bool>        m_readConfig;
+    static std::map<ConfigKey,boost::property_tree::ptree> m_root;
 };
 
 }